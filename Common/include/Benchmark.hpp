@@ -0,0 +1,227 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// SUÍTE DE BENCHMARKS (AQUECIMENTO, REPETIÇÕES, MEDIANA/P95, JSON, COMPARAÇÃO)
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Relógio dos benchmarks: nanossegundos desde um instante qualquer (só diferenças importam).
+ */
+typedef uint64_t (*BenchClock)();
+
+// Tempo real (steady_clock). Inclui esperas de E/S e o trabalho de outras threads.
+static uint64_t benchWallClock()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Tempo de CPU da thread atual. Ignora esperas e preempção, mas não conta o trabalho
+// entregue a outras threads (ex.: parallelFor do JobSystem).
+static uint64_t benchThreadCpuClock()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+    const uint64_t k = (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t u = (static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return (k + u) * 100; // Unidades de 100 ns.
+#else
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+/**
+ * @struct BenchmarkResult
+ * @brief Tempos de um caso (nome + tamanho da entrada) sobre as repetições medidas.
+ */
+struct BenchmarkResult {
+    std::string name;
+    uint64_t    size = 0;    // Tamanho da entrada (faces, pontos, materiais...).
+    int         runs = 0;
+    double      medianNs = 0.0, p95Ns = 0.0, minNs = 0.0, maxNs = 0.0, meanNs = 0.0;
+
+    std::string key() const { return name + "/" + std::to_string(size); }
+};
+
+/**
+ * @class BenchmarkSuite
+ * @brief Executa casos com aquecimento e repetições, imprime mediana e p95, grava os resultados
+ * em JSON e os compara com uma execução anterior (baseline).
+ * @details Cada caso tem um preparo opcional, fora da medição (ex.: apagar o arquivo que o
+ * caso escreve), e o corpo medido. Os `warmup` primeiros corpos são descartados. A mediana é
+ * o número usado na comparação: é estável contra picos isolados (o p95 os mostra).
+ * O relógio é trocável (`BenchClock`), então a mesma suíte mede tempo real ou de CPU.
+ */
+class BenchmarkSuite {
+public:
+    BenchmarkSuite(int warmup_, int runs_, BenchClock clock_ = benchWallClock)
+        : warmup(std::max(0, warmup_)), runs(std::max(1, runs_)), clock(clock_) {}
+
+    /**
+     * @brief Mede `body` em `runs` repetições (após `warmup`), chamando `setup` antes de cada uma.
+     */
+    const BenchmarkResult& run(const std::string& name, uint64_t size,
+        const std::function<void()>& body, const std::function<void()>& setup = nullptr)
+    {
+        std::vector<double> samples;
+        samples.reserve(runs);
+        for (int i = 0; i < warmup + runs; ++i) {
+            if (setup) setup();
+            const uint64_t start = clock();
+            body();
+            const uint64_t end = clock();
+            if (i >= warmup)
+                samples.push_back(static_cast<double>(end - start));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchmarkResult result;
+        result.name = name;
+        result.size = size;
+        result.runs = runs;
+        double sum = 0.0;
+        for (double ns : samples) sum += ns;
+        auto percentile = [&](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1) + 0.5)]; };
+        result.medianNs = percentile(0.50);
+        result.p95Ns = percentile(0.95);
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        result.meanNs = sum / samples.size();
+        std::printf("%-22s %10llu  mediana %10.3f ms | p95 %10.3f ms | min %10.3f ms\n",
+            name.c_str(), static_cast<unsigned long long>(size),
+            result.medianNs / 1e6, result.p95Ns / 1e6, result.minNs / 1e6);
+        std::fflush(stdout);
+        results.push_back(result);
+        return results.back();
+    }
+
+    const std::vector<BenchmarkResult>& all() const { return results; }
+
+    /**
+     * @brief Grava os resultados em JSON (um caso por linha, lido de volta por `readJson`).
+     */
+    bool writeJson(const std::string& path, const std::string& build, const std::string& timer) const
+    {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        std::fprintf(file, "{\n  \"build\": \"%s\",\n  \"timer\": \"%s\",\n  \"warmup\": %d,\n  \"runs\": %d,\n  \"results\": [\n",
+            build.c_str(), timer.c_str(), warmup, runs);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            std::fprintf(file, "    {\"name\": \"%s\", \"size\": %llu, \"runs\": %d, \"median_ns\": %.0f, \"p95_ns\": %.0f, "
+                "\"min_ns\": %.0f, \"max_ns\": %.0f, \"mean_ns\": %.0f}%s\n",
+                r.name.c_str(), static_cast<unsigned long long>(r.size), r.runs, r.medianNs, r.p95Ns,
+                r.minNs, r.maxNs, r.meanNs, i + 1 < results.size() ? "," : "");
+        }
+        std::fputs("  ]\n}\n", file);
+        std::fclose(file);
+        return true;
+    }
+
+    /**
+     * @brief Lê os casos de um arquivo gravado por `writeJson`.
+     */
+    static bool readJson(const std::string& path, std::vector<BenchmarkResult>& out)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+        std::string line;
+        while (std::getline(file, line)) {
+            BenchmarkResult r;
+            if (!stringField(line, "name", r.name))
+                continue;
+            r.size = static_cast<uint64_t>(numberField(line, "size"));
+            r.runs = static_cast<int>(numberField(line, "runs"));
+            r.medianNs = numberField(line, "median_ns");
+            r.p95Ns = numberField(line, "p95_ns");
+            r.minNs = numberField(line, "min_ns");
+            r.maxNs = numberField(line, "max_ns");
+            r.meanNs = numberField(line, "mean_ns");
+            out.push_back(r);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Compara as medianas com as da baseline e imprime a variação de cada caso.
+     * @param threshold Fração acima da qual um caso mais lento conta como regressão (0.10 = 10%).
+     * @return Número de regressões.
+     */
+    int compare(const std::vector<BenchmarkResult>& baseline, double threshold) const
+    {
+        int regressions = 0;
+        std::printf("\n%-33s %12s %12s %9s\n", "caso", "baseline ms", "atual ms", "variacao");
+        for (const BenchmarkResult& r : results) {
+            auto base = std::find_if(baseline.begin(), baseline.end(),
+                [&](const BenchmarkResult& b) { return b.key() == r.key(); });
+            if (base == baseline.end() || base->medianNs <= 0.0) {
+                std::printf("%-33s %12s %12.3f %9s\n", r.key().c_str(), "-", r.medianNs / 1e6, "novo");
+                continue;
+            }
+            const double change = r.medianNs / base->medianNs - 1.0;
+            const bool regressed = change > threshold;
+            regressions += regressed ? 1 : 0;
+            std::printf("%-33s %12.3f %12.3f %+8.1f%%%s\n", r.key().c_str(), base->medianNs / 1e6,
+                r.medianNs / 1e6, 100.0 * change, regressed ? "  REGRESSAO" : "");
+        }
+        return regressions;
+    }
+
+private:
+    static bool stringField(const std::string& line, const char* key, std::string& out)
+    {
+        const std::string pattern = std::string("\"") + key + "\": \"";
+        const size_t start = line.find(pattern);
+        if (start == std::string::npos)
+            return false;
+        const size_t begin = start + pattern.size();
+        const size_t end = line.find('"', begin);
+        if (end == std::string::npos)
+            return false;
+        out = line.substr(begin, end - begin);
+        return true;
+    }
+
+    static double numberField(const std::string& line, const char* key)
+    {
+        const std::string pattern = std::string("\"") + key + "\": ";
+        const size_t start = line.find(pattern);
+        return start == std::string::npos ? 0.0 : std::strtod(line.c_str() + start + pattern.size(), nullptr);
+    }
+
+    int                          warmup;
+    int                          runs;
+    BenchClock                   clock;
+    std::vector<BenchmarkResult> results;
+};
+
+#endif // BENCHMARK_HPP
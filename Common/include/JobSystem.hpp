@@ -0,0 +1,564 @@
+#ifndef JOBSYSTEM_HPP
+#define JOBSYSTEM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// SISTEMA DE TAREFAS COM ROUBO DE TRABALHO (WORK STEALING)
+// ----------------------------------------------------------------------------
+
+// Capacidade de cada deque de trabalhador (potência de 2). Uma tarefa que não cabe roda na hora.
+const int64_t JOB_DEQUE_CAPACITY = 4096;
+
+/**
+ * @struct JobState
+ * @brief Uma tarefa: a função, suas dependências pendentes e as tarefas que esperam por ela.
+ * @details Contagem de referências intrusiva: uma referência é do escalonador (liberada quando
+ * a tarefa termina) e as demais são dos JobHandle.
+ */
+struct JobState {
+    std::function<void()> fn;
+    std::atomic<int>      refs{ 1 };
+    std::atomic<int>      dependencies{ 0 }; // Tarefas anteriores ainda não concluídas.
+    std::atomic<bool>     done{ false };
+    std::mutex            mutex;             // Protege `continuations` e a passagem para `done`.
+    std::vector<JobState*> continuations;    // Tarefas que dependem desta.
+
+    explicit JobState(std::function<void()> fn_) : fn(std::move(fn_)) {}
+
+    void retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+    void release() { if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this; }
+};
+
+/**
+ * @class JobHandle
+ * @brief Referência a uma tarefa enviada ao JobSystem: serve para esperá-la ou encadear outras.
+ */
+class JobHandle {
+public:
+    JobHandle() = default;
+    explicit JobHandle(JobState* state_) : state(state_) { if (state) state->retain(); }
+    JobHandle(const JobHandle& o) : state(o.state) { if (state) state->retain(); }
+    JobHandle(JobHandle&& o) noexcept : state(o.state) { o.state = nullptr; }
+    JobHandle& operator=(JobHandle o) { std::swap(state, o.state); return *this; }
+    ~JobHandle() { if (state) state->release(); }
+
+    bool valid() const { return state != nullptr; }
+    bool done() const { return !state || state->done.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    JobState* state = nullptr;
+};
+
+/**
+ * @class ChaseLevDeque
+ * @brief Deque de tarefas de um trabalhador (Chase & Lev, "Dynamic Circular Work-Stealing Deque").
+ * @details O dono empilha e desempilha no fundo (LIFO, bom para a cache: a tarefa mais recente
+ * costuma usar os mesmos dados); as outras threads roubam do topo (FIFO, as tarefas mais antigas,
+ * em geral as maiores). Só `push`/`pop` no dono; `steal` em qualquer thread. A ordenação de
+ * memória segue Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (2013).
+ * Capacidade fixa: `push` falha se o deque estiver cheio.
+ */
+class ChaseLevDeque {
+public:
+    bool push(JobState* job)
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= JOB_DEQUE_CAPACITY) return false;
+        slots[b & (JOB_DEQUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        // Publica a tarefa (e o que ela captura) para os ladrões, que leem `bottom` com acquire.
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    JobState* pop()
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) { // Vazio.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        JobState* job = slots[b & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Último item: disputa com quem estiver roubando.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    JobState* steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        JobState* job = slots[t & (JOB_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr; // Outro ladrão (ou o dono) levou.
+        return job;
+    }
+
+private:
+    // Em linhas de cache separadas: `top` é disputado pelos ladrões, `bottom` é do dono.
+    // O deque fica dentro de Worker, alocado com new, que respeita alignas desde o C++17.
+    alignas(64) std::atomic<int64_t> top{ 0 };
+    alignas(64) std::atomic<int64_t> bottom{ 0 };
+    alignas(64) std::atomic<JobState*> slots[JOB_DEQUE_CAPACITY] = {};
+};
+
+/**
+ * @struct JobStats
+ * @brief Contadores acumulados do escalonador (para os microbenchmarks).
+ */
+struct JobStats {
+    uint64_t executed = 0; // Tarefas executadas (por trabalhadores e por threads ajudando em wait).
+    uint64_t stolen = 0;   // Tarefas roubadas do deque de outro trabalhador.
+};
+
+/**
+ * @class JobSystem
+ * @brief Escalonador de tarefas com um deque Chase-Lev por trabalhador e roubo de trabalho.
+ * @details
+ * - `submit` cria uma tarefa; `then` cria uma tarefa que só roda depois de outras (continuação);
+ *   `wait` espera uma tarefa; `parallelFor` divide um intervalo em tarefas de até `grain` itens.
+ * - Uma tarefa criada por um trabalhador vai para o deque dele; criada por outra thread (por
+ *   exemplo, a principal), vai para uma fila compartilhada.
+ * - Trabalhadores sem tarefa roubam de um deque escolhido ao acaso e, se não há nada em lugar
+ *   nenhum, dormem até a próxima tarefa.
+ * - Quem espera (`wait`, `parallelFor`) não fica parado: executa tarefas enquanto isso. Por isso
+ *   `parallelFor` e `wait` podem ser chamados de dentro de tarefas sem risco de impasse.
+ * As tarefas não devem lançar exceções. O destrutor descarta tarefas ainda não iniciadas:
+ * espere as que importam antes.
+ */
+class JobSystem {
+public:
+    /**
+     * @param threadCount Threads que executam tarefas, contando a que chama `wait`/`parallelFor`:
+     * são criados `threadCount - 1` trabalhadores (0 = std::thread::hardware_concurrency()).
+     * Com 1, não há trabalhadores e tudo roda em quem espera.
+     */
+    explicit JobSystem(unsigned int threadCount = 0)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int w = 0; w + 1 < threadCount; ++w) {
+            workers.emplace_back(new Worker());
+            workers.back()->rng = 0x9E3779B9u * (w + 1);
+        }
+        for (size_t w = 0; w < workers.size(); ++w)
+            workers[w]->thread = std::thread(&JobSystem::workerLoop, this, static_cast<int>(w));
+    }
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop = true;
+        }
+        sleepCv.notify_all();
+        for (auto& worker : workers) worker->thread.join();
+        // Tarefas nunca executadas (inclusive continuações cujas dependências não rodaram).
+        for (auto& worker : workers)
+            while (JobState* job = worker->deque.pop()) job->release();
+        for (JobState* job : injected) job->release();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Instância usada pela aplicação, criada no primeiro uso com uma thread por núcleo.
+     */
+    static JobSystem& shared()
+    {
+        static JobSystem instance;
+        return instance;
+    }
+
+    unsigned int threadCount() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+    /**
+     * @brief Cria uma tarefa que pode começar imediatamente.
+     */
+    template <typename Fn>
+    JobHandle submit(Fn fn)
+    {
+        JobState* job = new JobState(std::function<void()>(std::move(fn)));
+        JobHandle handle(job);
+        schedule(job);
+        return handle;
+    }
+
+    /**
+     * @brief Cria uma tarefa que só começa quando todas as de `prerequisites` tiverem terminado.
+     */
+    template <typename Fn>
+    JobHandle then(const std::vector<JobHandle>& prerequisites, Fn fn)
+    {
+        JobState* job = new JobState(std::function<void()>(std::move(fn)));
+        JobHandle handle(job);
+        // A unidade extra impede que a tarefa seja escalonada antes de registrada em todas.
+        job->dependencies.store(1, std::memory_order_relaxed);
+        for (const JobHandle& prerequisite : prerequisites) {
+            JobState* before = prerequisite.state;
+            if (!before) continue;
+            std::lock_guard<std::mutex> lock(before->mutex);
+            if (before->done.load(std::memory_order_relaxed)) continue;
+            job->dependencies.fetch_add(1, std::memory_order_relaxed);
+            before->continuations.push_back(job);
+        }
+        if (job->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            schedule(job);
+        return handle;
+    }
+
+    template <typename Fn>
+    JobHandle then(const JobHandle& prerequisite, Fn fn)
+    {
+        return then(std::vector<JobHandle>{ prerequisite }, std::move(fn));
+    }
+
+    /**
+     * @brief Espera a tarefa terminar, executando outras tarefas enquanto isso.
+     */
+    void wait(const JobHandle& handle)
+    {
+        helpUntil([&] { return handle.done(); });
+    }
+
+    /**
+     * @brief Executa `fn(begin, end)` sobre [0, count) em fatias de até `grain` itens e espera todas.
+     * @details O intervalo é dividido ao meio sob demanda: quem executa uma fatia grande deixa
+     * a metade direita no seu deque (para ser roubada) e segue com a esquerda, então as fatias
+     * pequenas só são criadas onde há threads ociosas para executá-las. As fatias são disjuntas;
+     * a chamadora também executa fatias.
+     */
+    template <typename Fn>
+    void parallelFor(size_t count, size_t grain, const Fn& fn)
+    {
+        if (count == 0) return;
+        grain = std::max<size_t>(1, grain);
+        if (count <= grain || workers.empty()) {
+            fn(size_t(0), count);
+            return;
+        }
+        std::atomic<size_t> remaining{ count };
+        splitRange(size_t(0), count, grain, fn, remaining);
+        helpUntil([&] { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    JobStats stats() const
+    {
+        JobStats total;
+        total.executed = helperExecuted.load(std::memory_order_relaxed);
+        for (const auto& worker : workers) {
+            total.executed += worker->executed.load(std::memory_order_relaxed);
+            total.stolen += worker->stolen.load(std::memory_order_relaxed);
+        }
+        total.stolen += helperStolen.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    struct Worker {
+        ChaseLevDeque         deque;
+        std::thread           thread;
+        uint32_t              rng = 1;          // Escolha da vítima dos roubos (xorshift).
+        std::atomic<uint64_t> executed{ 0 };
+        std::atomic<uint64_t> stolen{ 0 };
+    };
+
+    /**
+     * @brief Índice do trabalhador da thread atual neste JobSystem (-1 se não for trabalhador dele).
+     */
+    int currentWorker() const
+    {
+        const Context& context = threadContext();
+        return (context.owner == this) ? context.index : -1;
+    }
+
+    struct Context {
+        const JobSystem* owner = nullptr;
+        int              index = -1;
+    };
+
+    static Context& threadContext()
+    {
+        static thread_local Context context;
+        return context;
+    }
+
+    template <typename Fn>
+    void splitRange(size_t begin, size_t end, size_t grain, const Fn& fn, std::atomic<size_t>& remaining)
+    {
+        while (end - begin > grain) {
+            const size_t mid = begin + (end - begin) / 2;
+            schedule(new JobState([this, mid, end, grain, &fn, &remaining] {
+                splitRange(mid, end, grain, fn, remaining);
+            }));
+            end = mid;
+        }
+        fn(begin, end);
+        // Último acesso ao estado da chamadora: depois disso ela pode retornar.
+        remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+    }
+
+    void schedule(JobState* job)
+    {
+        const int self = currentWorker();
+        if (self >= 0) {
+            if (!workers[self]->deque.push(job)) {
+                execute(job); // Deque cheio: executa na hora.
+                workers[self]->executed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        else {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            injected.push_back(job);
+        }
+        queued.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            { std::lock_guard<std::mutex> lock(sleepMutex); }
+            sleepCv.notify_one();
+        }
+    }
+
+    void execute(JobState* job)
+    {
+        job->fn();
+        job->fn = nullptr; // Libera o que a função capturou.
+
+        std::vector<JobState*> ready;
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->done.store(true, std::memory_order_release);
+            ready.swap(job->continuations);
+        }
+        for (JobState* next : ready)
+            if (next->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                schedule(next);
+        job->release();
+    }
+
+    /**
+     * @brief Procura uma tarefa: no próprio deque, na fila compartilhada e, por fim, roubando.
+     */
+    JobState* findJob(int self, bool& stolen)
+    {
+        stolen = false;
+        JobState* job = nullptr;
+        if (self >= 0 && (job = workers[self]->deque.pop()) != nullptr) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+        {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            if (!injected.empty()) {
+                job = injected.front();
+                injected.pop_front();
+            }
+        }
+        if (job) {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+        if (workers.empty()) return nullptr;
+
+        uint32_t& rng = (self >= 0) ? workers[self]->rng : helperRng();
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        const size_t first = rng % workers.size();
+        for (size_t k = 0; k < workers.size(); ++k) {
+            const size_t victim = (first + k) % workers.size();
+            if (static_cast<int>(victim) == self) continue;
+            if ((job = workers[victim]->deque.steal()) != nullptr) {
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                stolen = true;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    static uint32_t& helperRng()
+    {
+        static thread_local uint32_t rng = 0x2545F491u ^
+            static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        if (rng == 0) rng = 1;
+        return rng;
+    }
+
+    template <typename Pred>
+    void helpUntil(Pred finished)
+    {
+        const int self = currentWorker();
+        while (!finished()) {
+            bool stolen;
+            if (JobState* job = findJob(self, stolen)) {
+                execute(job);
+                if (self >= 0) {
+                    workers[self]->executed.fetch_add(1, std::memory_order_relaxed);
+                    if (stolen) workers[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    helperExecuted.fetch_add(1, std::memory_order_relaxed);
+                    if (stolen) helperStolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void workerLoop(int index)
+    {
+        threadContext().owner = this;
+        threadContext().index = index;
+        Worker& self = *workers[index];
+        for (;;) {
+            bool stolen;
+            if (JobState* job = findJob(index, stolen)) {
+                execute(job);
+                self.executed.fetch_add(1, std::memory_order_relaxed);
+                if (stolen) self.stolen.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (queued.load(std::memory_order_seq_cst) > 0) {
+                // Há tarefa em algum deque, mas outra thread acabou de levá-la ou a está empilhando.
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            sleepCv.wait(lock, [&] { return stop || queued.load(std::memory_order_seq_cst) > 0; });
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+            if (stop) break;
+        }
+        threadContext() = Context();
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex             injectMutex;  // Fila das tarefas criadas fora dos trabalhadores.
+    std::deque<JobState*>  injected;
+
+    std::atomic<int64_t>   queued{ 0 };   // Tarefas escalonadas ainda não retiradas de nenhuma fila.
+    std::atomic<int>       sleepers{ 0 };
+    std::mutex             sleepMutex;
+    std::condition_variable sleepCv;
+    bool                   stop = false;
+
+    std::atomic<uint64_t>  helperExecuted{ 0 }; // Executadas por threads que não são trabalhadores.
+    std::atomic<uint64_t>  helperStolen{ 0 };
+};
+
+// ----------------------------------------------------------------------------
+// MICROBENCHMARKS DO ESCALONADOR
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Microbenchmarks do JobSystem. Executado com `--bench-jobs [threads máx.]`.
+ * @details
+ * 1. Custo de criação: tarefas vazias criadas pela thread principal (fila compartilhada) e
+ *    por uma tarefa (deque do trabalhador), em ns por tarefa, incluindo a espera.
+ * 2. Taxa de roubo: um parallelFor de custo desigual, com a fração de fatias roubadas.
+ * 3. Escalabilidade: o mesmo parallelFor com 1, 2, 4, ... threads, com o ganho sobre 1 thread.
+ */
+static void runJobSystemBenchmark(unsigned int maxThreads)
+{
+    typedef std::chrono::steady_clock Clock;
+    auto seconds = [](Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+    // Trabalho sintético de custo ~proporcional a `n`.
+    auto spin = [](size_t n) {
+        float x = 0.0f;
+        for (size_t k = 0; k < n; ++k) x += std::sin(static_cast<float>(k) * 0.001f);
+        return x;
+    };
+    std::atomic<int> sink{ 0 }; // Impede o compilador de remover o trabalho.
+
+    {
+        JobSystem jobs(maxThreads);
+        const int spawnCount = 200000;
+
+        std::vector<JobHandle> handles;
+        handles.reserve(spawnCount);
+        auto start = Clock::now();
+        for (int k = 0; k < spawnCount; ++k)
+            handles.push_back(jobs.submit([] {}));
+        for (const JobHandle& handle : handles) jobs.wait(handle);
+        std::printf("criacao (thread externa): %.1f ns/tarefa\n", 1e9 * seconds(start) / spawnCount);
+        handles.clear();
+
+        // Em lotes que cabem no deque (uma tarefa que não cabe roda na hora, sem ser escalonada).
+        const int batch = static_cast<int>(JOB_DEQUE_CAPACITY / 2);
+        start = Clock::now();
+        JobHandle root = jobs.submit([&] {
+            std::vector<JobHandle> children;
+            children.reserve(batch);
+            for (int k = 0; k < spawnCount; k += batch) {
+                for (int c = 0; c < batch; ++c)
+                    children.push_back(jobs.submit([] {}));
+                for (const JobHandle& child : children) jobs.wait(child);
+                children.clear();
+            }
+        });
+        jobs.wait(root);
+        std::printf("criacao (dentro de tarefa): %.1f ns/tarefa\n", 1e9 * seconds(start) / spawnCount);
+
+        const JobStats before = jobs.stats();
+        const size_t items = 1 << 14;
+        jobs.parallelFor(items, 16, [&](size_t begin, size_t end) {
+            float x = 0.0f;
+            for (size_t i = begin; i < end; ++i) x += spin((i % 64) * 64); // Custo desigual.
+            sink += static_cast<int>(x);
+        });
+        const JobStats after = jobs.stats();
+        const uint64_t executed = after.executed - before.executed;
+        const uint64_t stolen = after.stolen - before.stolen;
+        std::printf("roubo: %llu de %llu tarefas (%.1f%%) com %u threads\n",
+            static_cast<unsigned long long>(stolen), static_cast<unsigned long long>(executed),
+            executed ? 100.0 * stolen / executed : 0.0, jobs.threadCount());
+    }
+
+    const size_t items = 1 << 16;
+    double baseline = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        JobSystem jobs(threads);
+        auto body = [&](size_t begin, size_t end) {
+            float x = 0.0f;
+            for (size_t i = begin; i < end; ++i) x += spin(256);
+            sink += static_cast<int>(x);
+        };
+        jobs.parallelFor(items, 64, body); // aquecimento
+        const auto start = Clock::now();
+        jobs.parallelFor(items, 64, body);
+        const double elapsed = seconds(start);
+        if (threads == 1) baseline = elapsed;
+        std::printf("%2u threads: %8.2f ms, ganho %.2fx\n", threads, 1000.0 * elapsed,
+            elapsed > 0.0 ? baseline / elapsed : 0.0);
+    }
+}
+
+#endif // JOBSYSTEM_HPP
@@ -0,0 +1,224 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// PERFILADOR DE CPU (ZONAS COM ESCOPO, EXPORTAÇÃO PARA CHROME TRACE)
+// ----------------------------------------------------------------------------
+
+// Zonas guardadas por thread (potência de 2). As mais antigas são sobrescritas.
+const uint32_t PROFILER_RING_CAPACITY = 1u << 16;
+
+/**
+ * @struct ProfileEvent
+ * @brief Uma zona concluída: nome e instantes de início e fim, em nanossegundos desde o início
+ * do processo.
+ * @details Os campos são atômicos (lidos e escritos com `relaxed`, que em x86/x64 são movs
+ * comuns) porque `writeChromeTrace` pode ler o anel enquanto a thread dona ainda escreve nele.
+ */
+struct ProfileEvent {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t>    start{ 0 };
+    std::atomic<uint64_t>    end{ 0 };
+};
+
+/**
+ * @struct ProfileThreadBuffer
+ * @brief Anel de zonas de uma thread. Só a thread dona escreve; qualquer uma pode ler.
+ */
+struct ProfileThreadBuffer {
+    uint32_t              id = 0;          // tid no arquivo de trace.
+    std::string           threadName;      // Protegido pelo mutex do Profiler.
+    std::atomic<uint64_t> head{ 0 };       // Zonas já escritas (a próxima vai em head % capacidade).
+    std::unique_ptr<ProfileEvent[]> events; // Criado (com o mutex) na primeira zona da thread.
+};
+
+/**
+ * @class Profiler
+ * @brief Instrumentação leve de CPU: zonas com escopo (`PROFILE_ZONE`) gravadas em um anel por
+ * thread e exportadas no formato Trace Event JSON do Chrome (abre em ui.perfetto.dev ou
+ * chrome://tracing).
+ * @details Desligado, cada zona custa uma leitura atômica e um desvio. Ligado, duas leituras
+ * do relógio e três escritas no anel da thread, sem travas: o mutex só é usado quando uma
+ * thread grava a primeira zona (criação do anel) e na exportação. Os anéis das threads que
+ * terminaram continuam registrados, para que suas zonas entrem na exportação.
+ * Com `PROFILER_DISABLED` definido na compilação, `PROFILE_ZONE` não gera código.
+ */
+class Profiler {
+public:
+    static bool enabled() { return enabledFlag().load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { enabledFlag().store(on, std::memory_order_relaxed); }
+
+    /**
+     * @brief Nanossegundos desde a primeira chamada (o início do processo, na prática).
+     */
+    static uint64_t now()
+    {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    /**
+     * @brief Grava uma zona concluída no anel da thread atual. `name` precisa viver até a
+     * exportação (em geral, um literal).
+     */
+    static void record(const char* name, uint64_t start, uint64_t end)
+    {
+        ProfileThreadBuffer& buffer = threadBuffer();
+        if (!buffer.events) {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            buffer.events.reset(new ProfileEvent[PROFILER_RING_CAPACITY]);
+        }
+        const uint64_t index = buffer.head.load(std::memory_order_relaxed);
+        ProfileEvent& event = buffer.events[index & (PROFILER_RING_CAPACITY - 1)];
+        event.name.store(name, std::memory_order_relaxed);
+        event.start.store(start, std::memory_order_relaxed);
+        event.end.store(end, std::memory_order_relaxed);
+        buffer.head.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Nome da thread atual no trace (ex.: "principal", "renderizacao").
+     */
+    static void setThreadName(const std::string& name)
+    {
+        ProfileThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffer.threadName = name;
+    }
+
+    /**
+     * @brief Grava em `path` as zonas ainda presentes nos anéis de todas as threads, no formato
+     * Trace Event JSON (eventos completos, "ph": "X"). A gravação continua durante a exportação;
+     * zonas sobrescritas enquanto eram lidas são descartadas.
+     * @return Número de zonas gravadas, ou -1 se o arquivo não pôde ser criado.
+     */
+    static long long writeChromeTrace(const std::string& path)
+    {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return -1;
+
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+        bool first = true;
+        long long written = 0;
+        for (const auto& buffer : reg.buffers) {
+            std::fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"",
+                first ? "" : ",\n", buffer->id);
+            const std::string threadName = buffer->threadName.empty() ? "thread " + std::to_string(buffer->id) : buffer->threadName;
+            writeEscaped(file, threadName.c_str());
+            std::fputs("\"}}", file);
+            first = false;
+
+            if (!buffer->events)
+                continue;
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const uint64_t begin = head > PROFILER_RING_CAPACITY ? head - PROFILER_RING_CAPACITY : 0;
+            for (uint64_t i = begin; i < head; ++i) {
+                const ProfileEvent& event = buffer->events[i & (PROFILER_RING_CAPACITY - 1)];
+                const char* name = event.name.load(std::memory_order_relaxed);
+                const uint64_t start = event.start.load(std::memory_order_relaxed);
+                const uint64_t end = event.end.load(std::memory_order_relaxed);
+                // Se a thread dona já deu a volta no anel até este índice, o evento pode estar misturado.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (buffer->head.load(std::memory_order_relaxed) - i >= PROFILER_RING_CAPACITY || !name)
+                    continue;
+                std::fprintf(file, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"",
+                    buffer->id, start / 1000.0, (end - start) / 1000.0);
+                writeEscaped(file, name);
+                std::fputs("\"}", file);
+                ++written;
+            }
+        }
+        std::fputs("\n]}\n", file);
+        std::fclose(file);
+        return written;
+    }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ProfileThreadBuffer>> buffers;
+    };
+
+    static std::atomic<bool>& enabledFlag()
+    {
+        static std::atomic<bool> flag{ false };
+        return flag;
+    }
+
+    static Registry& registry()
+    {
+        static Registry reg;
+        return reg;
+    }
+
+    static ProfileThreadBuffer& threadBuffer()
+    {
+        // Ponteiro simples (sem destrutor) para o acesso thread_local ficar barato; o registro é o dono.
+        static thread_local ProfileThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            auto owned = std::make_shared<ProfileThreadBuffer>();
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            owned->id = static_cast<uint32_t>(reg.buffers.size()) + 1;
+            reg.buffers.push_back(owned);
+            buffer = owned.get();
+        }
+        return *buffer;
+    }
+
+    static void writeEscaped(FILE* file, const char* text)
+    {
+        for (; *text; ++text) {
+            const char c = *text;
+            if (c == '"' || c == '\\') std::fputc('\\', file);
+            if (static_cast<unsigned char>(c) >= 0x20) std::fputc(c, file);
+        }
+    }
+};
+
+/**
+ * @class ProfileZone
+ * @brief Marca o escopo atual como uma zona do perfil (do construtor ao destrutor).
+ * @details Se o perfilador estiver desligado quando a zona abre, ela não faz nada, mesmo que
+ * ele seja ligado antes de ela fechar.
+ */
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name_)
+        : name(Profiler::enabled() ? name_ : nullptr), start(name ? Profiler::now() : 0) {}
+    ~ProfileZone()
+    {
+        if (name)
+            Profiler::record(name, start, Profiler::now());
+    }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t    start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#ifdef PROFILER_DISABLED
+#define PROFILE_ZONE(name) ((void)0)
+#else
+// Zona do início do comando até o fim do escopo. `name` deve ser um literal.
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#endif
+
+#endif // PROFILER_HPP
@@ -0,0 +1,343 @@
+#ifndef ANIMATIONFILE_HPP
+#define ANIMATIONFILE_HPP
+
+#include "MappedFile.hpp" // Leitura do arquivo via mmap, sem cópia.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// FORMATO BINÁRIO DE ANIMAÇÃO (.anim)
+// ----------------------------------------------------------------------------
+//
+// Layout (little-endian):
+//   AnimationFileHeader (48 bytes)
+//   blockCount blocos de tamanho fixo, cada um com `blockSize` amostras:
+//     posições: 3 x uint16 por amostra (quantizadas na caixa envolvente), ou, com
+//               ANIM_FLAG_DELTA, 3 x uint16 para a primeira amostra e 3 x int8 de
+//               diferença para cada amostra seguinte, em unidades de 2^deltaShift passos
+//               de quantização;
+//     frames:   (com ANIM_FLAG_FRAMES) 4 x int16 normalizados por amostra (quaternion x, y, z, w).
+//   O último bloco é completado com zeros.
+// Como todo bloco tem o mesmo tamanho, o bloco b começa em sizeof(header) + b * blockBytes:
+// qualquer trecho da gravação pode ser decodificado sem ler os anteriores.
+
+const uint16_t ANIM_FLAG_DELTA = 1u << 0;  // Posições codificadas como diferenças dentro de cada bloco.
+const uint16_t ANIM_FLAG_FRAMES = 1u << 1; // Orientações pré-calculadas incluídas.
+const uint32_t ANIM_DEFAULT_BLOCK_SIZE = 256;
+const int      ANIM_MAX_DELTA_SHIFT = 6;  // Erro máximo extra das diferenças: 2^5 passos (~0.05% da caixa).
+
+/**
+ * @struct AnimationFileHeader
+ * @brief Cabeçalho do arquivo `.anim`.
+ */
+struct AnimationFileHeader {
+    char     magic[4];     // "ANIM"
+    uint16_t version;      // 1
+    uint16_t flags;        // ANIM_FLAG_*
+    uint32_t sampleCount;  // Total de amostras.
+    uint32_t blockSize;    // Amostras por bloco.
+    float    boundsMin[3]; // Caixa envolvente usada na quantização.
+    float    boundsMax[3];
+    uint8_t  deltaShift;   // Com ANIM_FLAG_DELTA: cada unidade de diferença vale 2^deltaShift passos.
+    uint8_t  padding[3];
+    uint32_t reserved;
+};
+static_assert(sizeof(AnimationFileHeader) == 48, "AnimationFileHeader deve ter 48 bytes");
+
+/**
+ * @brief Bytes ocupados por um bloco, dado o cabeçalho.
+ */
+inline size_t animationBlockBytes(uint16_t flags, uint32_t blockSize)
+{
+    size_t positions = (flags & ANIM_FLAG_DELTA) ? 6 + 3 * size_t(blockSize - 1) : 6 * size_t(blockSize);
+    size_t frames = (flags & ANIM_FLAG_FRAMES) ? 8 * size_t(blockSize) : 0;
+    return positions + frames;
+}
+
+/**
+ * @brief Verifica se o caminho usa a extensão do formato binário (".anim").
+ */
+inline bool isBinaryAnimationFile(const std::string& path)
+{
+    const std::string ext = ".anim";
+    return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+/**
+ * @brief Codifica as posições quantizadas de todos os blocos como diferenças de 8 bits.
+ * @details Cada diferença é medida em relação ao valor que o decodificador vai reconstruir
+ * (DPCM em laço fechado), então o erro de arredondamento não se acumula ao longo do bloco.
+ * @return false se algum passo não couber em int8 com o `shift` dado.
+ */
+inline bool encodeAnimationDeltas(const std::vector<uint16_t>& quantized, uint32_t blockSize, int shift, std::vector<int8_t>& deltas)
+{
+    const size_t count = quantized.size() / 3;
+    const int unit = 1 << shift;
+    deltas.assign(count * 3, 0);
+    int recon[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < count; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            const int target = quantized[i * 3 + a];
+            if (i % blockSize == 0) { // Início de bloco: amostra absoluta.
+                recon[a] = target;
+                continue;
+            }
+            const int diff = target - recon[a];
+            const int r = (diff >= 0) ? (diff + unit / 2) >> shift : -((-diff + unit / 2) >> shift);
+            if (r < -128 || r > 127) return false;
+            recon[a] += r * unit;
+            if (recon[a] < 0 || recon[a] > 65535) return false;
+            deltas[i * 3 + a] = static_cast<int8_t>(r);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Grava uma trajetória no formato `.anim`.
+ * @param points Posições das amostras.
+ * @param frames Orientação de cada amostra (opcional; nullptr para omitir).
+ * @param deltaEncode Tenta a codificação por diferenças (8 bits por componente), usando o menor
+ * `deltaShift` em que todos os passos cabem. Se nem ANIM_MAX_DELTA_SHIFT for suficiente,
+ * grava as posições absolutas (16 bits).
+ * @return false se o arquivo não pôde ser criado.
+ */
+inline bool writeAnimationFile(const std::string& path,
+    const std::vector<glm::vec3>& points,
+    const std::vector<glm::quat>* frames,
+    bool deltaEncode,
+    uint32_t blockSize = ANIM_DEFAULT_BLOCK_SIZE)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Falha ao criar " << path << '\n';
+        return false;
+    }
+
+    AnimationFileHeader header = {};
+    std::memcpy(header.magic, "ANIM", 4);
+    header.version = 1;
+    header.sampleCount = static_cast<uint32_t>(points.size());
+    header.blockSize = std::max<uint32_t>(1, blockSize);
+
+    // Caixa envolvente e quantização para 16 bits por componente.
+    glm::vec3 bmin(0.0f), bmax(0.0f);
+    if (!points.empty()) {
+        bmin = bmax = points[0];
+        for (const auto& p : points) {
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+    }
+    for (int a = 0; a < 3; ++a) {
+        header.boundsMin[a] = bmin[a];
+        header.boundsMax[a] = bmax[a];
+    }
+    const glm::vec3 extent = bmax - bmin;
+    std::vector<uint16_t> quantized(points.size() * 3);
+    for (size_t i = 0; i < points.size(); ++i)
+        for (int a = 0; a < 3; ++a) {
+            float t = (extent[a] > 0.0f) ? (points[i][a] - bmin[a]) / extent[a] : 0.0f;
+            quantized[i * 3 + a] = static_cast<uint16_t>(std::lround(glm::clamp(t, 0.0f, 1.0f) * 65535.0f));
+        }
+
+    std::vector<int8_t> deltas;
+    if (deltaEncode) {
+        int shift = 0;
+        while (shift <= ANIM_MAX_DELTA_SHIFT && !encodeAnimationDeltas(quantized, header.blockSize, shift, deltas))
+            ++shift;
+        if (shift <= ANIM_MAX_DELTA_SHIFT) {
+            header.flags |= ANIM_FLAG_DELTA;
+            header.deltaShift = static_cast<uint8_t>(shift);
+        }
+        else
+            std::cout << path << ": passos grandes demais para diferenças de 8 bits; gravando posições absolutas.\n";
+    }
+    if (frames && frames->size() == points.size())
+        header.flags |= ANIM_FLAG_FRAMES;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const uint32_t B = header.blockSize;
+    const size_t blockCount = (points.size() + B - 1) / B;
+    std::vector<uint8_t> block(animationBlockBytes(header.flags, B));
+    for (size_t b = 0; b < blockCount; ++b) {
+        std::fill(block.begin(), block.end(), uint8_t(0));
+        const size_t first = b * B;
+        const size_t count = std::min<size_t>(B, points.size() - first);
+        uint8_t* out = block.data();
+
+        if (header.flags & ANIM_FLAG_DELTA) {
+            std::memcpy(out, &quantized[first * 3], 6);
+            if (count > 1)
+                std::memcpy(out + 6, &deltas[(first + 1) * 3], (count - 1) * 3);
+            out += 6 + 3 * size_t(B - 1);
+        }
+        else {
+            std::memcpy(out, &quantized[first * 3], count * 6);
+            out += 6 * size_t(B);
+        }
+
+        if (header.flags & ANIM_FLAG_FRAMES) {
+            for (size_t k = 0; k < count; ++k) {
+                const glm::quat& q = (*frames)[first + k];
+                const float c[4] = { q.x, q.y, q.z, q.w };
+                for (int a = 0; a < 4; ++a) {
+                    int16_t v = static_cast<int16_t>(std::lround(glm::clamp(c[a], -1.0f, 1.0f) * 32767.0f));
+                    std::memcpy(out + (k * 4 + a) * 2, &v, 2);
+                }
+            }
+        }
+        file.write(reinterpret_cast<const char*>(block.data()), block.size());
+    }
+    return file.good();
+}
+
+/**
+ * @class AnimationFile
+ * @brief Leitor do formato `.anim`, com o arquivo mapeado em memória.
+ * @details Decodifica blocos individualmente (acesso aleatório) ou a gravação inteira.
+ */
+class AnimationFile {
+public:
+    /**
+     * @brief Mapeia e valida o arquivo. Retorna false se não existir ou não for um `.anim` válido.
+     */
+    bool open(const std::string& path)
+    {
+        return open(path, 0, SIZE_MAX);
+    }
+
+    /**
+     * @brief Como open(path), para uma gravação guardada no trecho [offset, offset + length) de
+     * outro arquivo (uma seção de um pacote de cena).
+     */
+    bool open(const std::string& path, size_t offset, size_t length)
+    {
+        if (!file.open(path, offset, length) || file.size() < sizeof(AnimationFileHeader)) {
+            file.close();
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "ANIM", 4) != 0 || header.version != 1 || header.blockSize == 0
+            || header.deltaShift > 15) {
+            std::cerr << path << ": cabeçalho de animação inválido\n";
+            file.close();
+            return false;
+        }
+        blockBytes = animationBlockBytes(header.flags, header.blockSize);
+        if (file.size() < sizeof(header) + blockCount() * blockBytes) {
+            std::cerr << path << ": arquivo de animação truncado\n";
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool     isOpen() const { return file.isOpen(); }
+    bool     hasFrames() const { return (header.flags & ANIM_FLAG_FRAMES) != 0; }
+    uint32_t sampleCount() const { return header.sampleCount; }
+    uint32_t blockSize() const { return header.blockSize; }
+    size_t   blockCount() const { return (size_t(header.sampleCount) + header.blockSize - 1) / header.blockSize; }
+
+    /**
+     * @brief Número de amostras válidas no bloco `b` (o último pode ser parcial).
+     */
+    size_t blockSamples(size_t b) const
+    {
+        return std::min<size_t>(header.blockSize, header.sampleCount - b * size_t(header.blockSize));
+    }
+
+    /**
+     * @brief Posição (em bytes, desde o início do arquivo) do bloco `b`.
+     */
+    size_t blockOffset(size_t b) const { return sizeof(header) + b * blockBytes; }
+
+    /**
+     * @brief Ponteiro para os bytes do bloco `b` dentro do mapeamento.
+     */
+    const uint8_t* blockData(size_t b) const { return file.data() + blockOffset(b); }
+
+    size_t            bytesPerBlock() const { return blockBytes; }
+    const MappedFile& mapping() const { return file; }
+
+    /**
+     * @brief Decodifica o bloco `b`.
+     * @param[out] positions Recebe blockSamples(b) posições.
+     * @param[out] frames Recebe as orientações (ignorado se nullptr ou se o arquivo não as tiver).
+     */
+    void decodeBlock(size_t b, glm::vec3* positions, glm::quat* frames) const
+    {
+        const size_t count = blockSamples(b);
+        const uint32_t B = header.blockSize;
+        const uint8_t* in = blockData(b);
+
+        glm::vec3 scale, offset;
+        for (int a = 0; a < 3; ++a) {
+            offset[a] = header.boundsMin[a];
+            scale[a] = (header.boundsMax[a] - header.boundsMin[a]) / 65535.0f;
+        }
+
+        uint16_t q[3];
+        std::memcpy(q, in, 6);
+        if (header.flags & ANIM_FLAG_DELTA) {
+            const int8_t* deltas = reinterpret_cast<const int8_t*>(in + 6);
+            const int unit = 1 << header.deltaShift;
+            int r[3] = { q[0], q[1], q[2] };
+            for (size_t k = 0; k < count; ++k) {
+                if (k > 0)
+                    for (int a = 0; a < 3; ++a)
+                        r[a] += deltas[(k - 1) * 3 + a] * unit;
+                positions[k] = offset + scale * glm::vec3(float(r[0]), float(r[1]), float(r[2]));
+            }
+            in += 6 + 3 * size_t(B - 1);
+        }
+        else {
+            for (size_t k = 0; k < count; ++k) {
+                std::memcpy(q, in + k * 6, 6);
+                positions[k] = offset + scale * glm::vec3(q[0], q[1], q[2]);
+            }
+            in += 6 * size_t(B);
+        }
+
+        if (frames && hasFrames()) {
+            for (size_t k = 0; k < count; ++k) {
+                int16_t c[4];
+                std::memcpy(c, in + k * 8, 8);
+                frames[k] = glm::normalize(glm::quat(c[3] / 32767.0f, c[0] / 32767.0f, c[1] / 32767.0f, c[2] / 32767.0f));
+            }
+        }
+    }
+
+    /**
+     * @brief Decodifica a gravação inteira.
+     * @param[out] frames Preenchido apenas se o arquivo tiver orientações (pode ser nullptr).
+     */
+    void readAll(std::vector<glm::vec3>& positions, std::vector<glm::quat>* frames) const
+    {
+        positions.resize(header.sampleCount);
+        const bool withFrames = frames && hasFrames();
+        if (frames) frames->resize(withFrames ? header.sampleCount : 0);
+        for (size_t b = 0; b < blockCount(); ++b) {
+            const size_t first = b * header.blockSize;
+            decodeBlock(b, &positions[first], withFrames ? &(*frames)[first] : nullptr);
+        }
+    }
+
+private:
+    MappedFile          file;
+    AnimationFileHeader header = {};
+    size_t              blockBytes = 0;
+};
+
+#endif // ANIMATIONFILE_HPP
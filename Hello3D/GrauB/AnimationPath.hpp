@@ -0,0 +1,187 @@
+#ifndef ANIMATIONPATH_HPP
+#define ANIMATIONPATH_HPP
+
+// Includes padrão do C++ e da biblioteca GLM para matemática de vetores e matrizes.
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <cmath>
+
+// ----------------------------------------------------------------------------
+// TRAJETÓRIA DE ANIMAÇÃO PARAMETRIZADA POR DISTÂNCIA
+// ----------------------------------------------------------------------------
+
+/**
+ * @struct AnimationCursor
+ * @brief Estado de um objeto que percorre uma AnimationPath.
+ * @details Guarda, além da distância percorrida, o segmento onde ela cai. Como a distância
+ * avança pouco a cada frame, o segmento é atualizado andando a partir do anterior
+ * (custo O(1) amortizado), sem busca binária.
+ */
+struct AnimationCursor {
+    float  distance = 0.0f; // Distância percorrida desde o início da trajetória.
+    size_t segment = 0;     // Segmento atual: entre as amostras `segment` e `segment + 1`.
+};
+
+/**
+ * @struct AnimationPath
+ * @brief Tabela de comprimento de arco sobre os pontos de animação (`animationPositions`).
+ * @details A trajetória é tratada como um laço fechado (a última amostra liga-se à primeira),
+ * assim como a malha da pista. Permite avançar por distância (velocidade * dt) e
+ * interpolar posição e orientação entre amostras, tornando a velocidade do objeto
+ * independente da densidade de amostragem e da taxa de quadros.
+ * A orientação em cada amostra é pré-calculada como um referencial de rotação mínima
+ * (rotation-minimizing frame) guardado em quaternions: animar é só consultar a tabela e
+ * fazer slerp entre as duas amostras vizinhas.
+ */
+struct AnimationPath {
+    std::vector<glm::vec3> points;     // Amostras da trajetória.
+    std::vector<glm::vec3> tangents;   // Tangente unitária em cada amostra (diferença central).
+    std::vector<glm::quat> frames;     // Orientação em cada amostra (eixos: X lateral, Y cima, Z frente).
+    std::vector<float>     cumulative; // Distância até cada amostra; cumulative[n] = comprimento do laço.
+
+    AnimationPath() = default;
+
+    explicit AnimationPath(const std::vector<glm::vec3>& points_)
+        : AnimationPath(points_, std::vector<glm::quat>())
+    {
+    }
+
+    /**
+     * @brief Constrói a trajetória reaproveitando orientações já calculadas (p.ex. lidas de um `.anim`).
+     * @details Se `frames_` não tiver uma orientação por ponto, elas são recalculadas.
+     */
+    AnimationPath(const std::vector<glm::vec3>& points_, const std::vector<glm::quat>& frames_)
+        : points(points_)
+    {
+        const size_t n = points.size();
+        if (n < 2) {
+            points.clear();
+            return;
+        }
+
+        cumulative.resize(n + 1);
+        cumulative[0] = 0.0f;
+        for (size_t i = 1; i <= n; ++i)
+            cumulative[i] = cumulative[i - 1] + glm::length(points[i % n] - points[i - 1]);
+
+        tangents.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            glm::vec3 d = points[(i + 1) % n] - points[(i + n - 1) % n];
+            float len = glm::length(d);
+            tangents[i] = (len > 1e-6f) ? d / len : glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+
+        if (frames_.size() == n)
+            frames = frames_;
+        else
+            buildFrames();
+    }
+
+    bool  empty() const { return points.empty(); }
+    float length() const { return cumulative.empty() ? 0.0f : cumulative.back(); }
+
+    /**
+     * @brief Avança (ou recua, se `delta` < 0) o cursor pela distância `delta`, dando a volta no laço.
+     */
+    void advance(AnimationCursor& cursor, float delta) const
+    {
+        const float total = length();
+        if (total <= 0.0f) return;
+
+        cursor.distance += delta;
+        if (cursor.distance >= total || cursor.distance < 0.0f) {
+            cursor.distance = std::fmod(cursor.distance, total);
+            if (cursor.distance < 0.0f) cursor.distance += total;
+            cursor.segment = (delta >= 0.0f) ? 0 : points.size() - 1;
+        }
+
+        const size_t last = points.size() - 1;
+        if (cursor.segment > last) cursor.segment = last;
+        while (cursor.segment < last && cumulative[cursor.segment + 1] <= cursor.distance)
+            ++cursor.segment;
+        while (cursor.segment > 0 && cumulative[cursor.segment] > cursor.distance)
+            --cursor.segment;
+    }
+
+    /**
+     * @brief Posição e orientação interpoladas na posição do cursor.
+     */
+    void sample(const AnimationCursor& cursor, glm::vec3& position, glm::quat& orientation) const
+    {
+        const size_t n = points.size();
+        const size_t i = cursor.segment;
+        const size_t j = (i + 1) % n;
+
+        const float span = cumulative[i + 1] - cumulative[i];
+        const float f = (span > 0.0f) ? glm::clamp((cursor.distance - cumulative[i]) / span, 0.0f, 1.0f) : 0.0f;
+
+        position = glm::mix(points[i], points[j], f);
+        orientation = glm::slerp(frames[i], frames[j], f);
+    }
+
+    /**
+     * @brief Referencial inicial a partir da tangente e do "cima" do mundo (Y-up).
+     * @details Se a tangente for vertical, o produto vetorial com Y se anula; nesse caso
+     * usa-se o eixo Z do mundo como referência, evitando NaNs.
+     */
+    static glm::vec3 initialUp(const glm::vec3& forward)
+    {
+        glm::vec3 right = glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        if (glm::dot(right, right) < 1e-8f)
+            right = glm::cross(forward, glm::vec3(0.0f, 0.0f, 1.0f));
+        return glm::normalize(glm::cross(glm::normalize(right), forward));
+    }
+
+private:
+    /**
+     * @brief Pré-calcula `frames` com o método da dupla reflexão (Wang et al., 2008).
+     * @details O vetor "cima" da amostra i é refletido duas vezes para a amostra i+1: primeiro
+     * pelo plano bissetor do segmento, depois pelo plano que leva a tangente refletida até a
+     * tangente seguinte. O resultado gira o mínimo possível em torno da tangente, então o
+     * objeto não "torce" sem necessidade. Como a trajetória é um laço, a torção residual
+     * acumulada ao voltar à primeira amostra é distribuída ao longo do comprimento.
+     */
+    void buildFrames()
+    {
+        const size_t n = points.size();
+        std::vector<glm::vec3> ups(n + 1);
+        ups[0] = initialUp(tangents[0]);
+
+        for (size_t i = 0; i < n; ++i) {
+            const size_t j = (i + 1) % n;
+            const glm::vec3 v1 = points[j] - points[i];
+            const float c1 = glm::dot(v1, v1);
+            if (c1 < 1e-12f) {
+                ups[i + 1] = ups[i];
+                continue;
+            }
+            const glm::vec3 rL = ups[i] - (2.0f / c1) * glm::dot(v1, ups[i]) * v1;
+            const glm::vec3 tL = tangents[i] - (2.0f / c1) * glm::dot(v1, tangents[i]) * v1;
+            const glm::vec3 v2 = tangents[j] - tL;
+            const float c2 = glm::dot(v2, v2);
+            glm::vec3 r = (c2 < 1e-12f) ? rL : rL - (2.0f / c2) * glm::dot(v2, rL) * v2;
+            // Reortogonaliza contra a tangente para não acumular erro numérico.
+            r -= glm::dot(r, tangents[j]) * tangents[j];
+            const float len = glm::length(r);
+            ups[i + 1] = (len > 1e-6f) ? r / len : initialUp(tangents[j]);
+        }
+
+        // Ângulo (em torno da tangente 0) entre o "cima" transportado pelo laço e o inicial.
+        const glm::vec3 side0 = glm::cross(tangents[0], ups[0]);
+        const float twist = std::atan2(glm::dot(ups[n], side0), glm::dot(ups[n], ups[0]));
+        const float total = length();
+
+        frames.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            const float correction = (total > 0.0f) ? -twist * (cumulative[i] / total) : 0.0f;
+            const glm::vec3 up = glm::angleAxis(correction, tangents[i]) * ups[i];
+            const glm::vec3 forward = tangents[i];
+            const glm::vec3 side = glm::cross(up, forward);
+            frames[i] = glm::normalize(glm::quat_cast(glm::mat3(side, up, forward)));
+        }
+    }
+};
+
+#endif // ANIMATIONPATH_HPP
@@ -0,0 +1,231 @@
+#ifndef ANIMATIONSTREAM_HPP
+#define ANIMATIONSTREAM_HPP
+
+#include "AnimationFile.hpp" // Gravação em blocos de tamanho fixo (acesso aleatório por bloco).
+#include "AnimationPath.hpp" // AnimationPath::initialUp para gravações sem orientações.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+// ----------------------------------------------------------------------------
+// REPRODUÇÃO EM STREAMING DE GRAVAÇÕES LONGAS
+// ----------------------------------------------------------------------------
+
+// Gravações com mais amostras que isto são reproduzidas em streaming em vez de carregadas inteiras.
+const uint32_t ANIM_STREAM_THRESHOLD = 1u << 20;
+// Blocos decodificados mantidos em memória (o atual e os seguintes).
+const size_t ANIM_STREAM_WINDOW_BLOCKS = 8;
+
+/**
+ * @class AnimationStream
+ * @brief Reproduz um `.anim` arbitrariamente grande com memória limitada.
+ * @details Mantém uma janela deslizante de `window` blocos decodificados: o bloco onde está o
+ * cursor e os seguintes. Uma thread de pré-carregamento decodifica os próximos blocos enquanto
+ * o atual é reproduzido, então as faltas de página e a decodificação acontecem fora da thread
+ * principal e cruzar a fronteira de um bloco é só trocar de slot. Os blocos já consumidos são
+ * devolvidos ao sistema (MappedFile::release), de modo que o uso de memória física não cresce
+ * com o tamanho da gravação.
+ * A gravação é tratada como um laço fechado, como a AnimationPath; o cursor só avança.
+ */
+class AnimationStream {
+public:
+    explicit AnimationStream(AnimationFile&& file_, size_t window_ = ANIM_STREAM_WINDOW_BLOCKS)
+        : file(std::move(file_))
+    {
+        window = std::max<size_t>(2, window_);
+        slots.resize(window);
+        for (auto& slot : slots) {
+            slot.positions.resize(file.blockSize());
+            if (file.hasFrames()) slot.frames.resize(file.blockSize());
+        }
+        if (file.sampleCount() >= 2)
+            worker = std::thread(&AnimationStream::prefetchLoop, this);
+    }
+
+    ~AnimationStream()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    AnimationStream(const AnimationStream&) = delete;
+    AnimationStream& operator=(const AnimationStream&) = delete;
+
+    bool   empty() const { return file.sampleCount() < 2; }
+    size_t stalls() const { return stallCount.load(); } // Vezes em que a thread principal esperou um bloco.
+
+    /**
+     * @brief Avança o cursor pela distância `delta` (valores negativos são ignorados).
+     */
+    void advance(float delta)
+    {
+        if (empty() || !(delta > 0.0f)) return;
+        segmentDistance += delta;
+        // Limita a uma volta completa por chamada: uma gravação com todos os pontos iguais
+        // nunca consumiria a distância.
+        for (uint32_t steps = 0; steps < file.sampleCount(); ++steps) {
+            glm::vec3 p0, p1;
+            segmentEnds(p0, p1, nullptr, nullptr);
+            const float len = glm::length(p1 - p0);
+            if (segmentDistance < len) return;
+            segmentDistance -= len;
+            stepSample();
+        }
+        segmentDistance = 0.0f;
+    }
+
+    /**
+     * @brief Posição e orientação interpoladas na posição atual do cursor.
+     */
+    void sample(glm::vec3& position, glm::quat& orientation)
+    {
+        if (empty()) {
+            position = glm::vec3(0.0f);
+            orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            return;
+        }
+        glm::vec3 p0, p1;
+        glm::quat q0, q1;
+        segmentEnds(p0, p1, &q0, &q1);
+        const float len = glm::length(p1 - p0);
+        const float f = (len > 0.0f) ? glm::clamp(segmentDistance / len, 0.0f, 1.0f) : 0.0f;
+        position = glm::mix(p0, p1, f);
+
+        if (file.hasFrames()) {
+            orientation = glm::slerp(q0, q1, f);
+        }
+        else {
+            // Sem orientações gravadas: base alinhada à direção do segmento.
+            const glm::vec3 forward = (len > 1e-6f) ? (p1 - p0) / len : glm::vec3(0.0f, 0.0f, 1.0f);
+            const glm::vec3 up = AnimationPath::initialUp(forward);
+            orientation = glm::quat_cast(glm::mat3(glm::cross(up, forward), up, forward));
+        }
+    }
+
+private:
+    struct Slot {
+        size_t                 sequence = SIZE_MAX; // Posição na sequência de reprodução (SIZE_MAX = nenhuma).
+        bool                   ready = false;       // Decodificação concluída.
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> frames;
+    };
+
+    /**
+     * @brief Garante que o bloco na posição `seq` da sequência (dentro da janela) está decodificado,
+     * esperando se preciso.
+     */
+    const Slot& acquire(size_t seq)
+    {
+        Slot& slot = slots[seq % window];
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!(slot.sequence == seq && slot.ready)) {
+            ++stallCount;
+            wake.notify_all();
+            decoded.wait(lock, [&] { return slot.sequence == seq && slot.ready; });
+        }
+        return slot;
+    }
+
+    size_t blockOf(size_t seq) const { return seq % file.blockCount(); }
+
+    /**
+     * @brief Extremos do segmento atual: amostra do cursor e a seguinte (que pode estar no próximo bloco).
+     */
+    void segmentEnds(glm::vec3& p0, glm::vec3& p1, glm::quat* q0, glm::quat* q1)
+    {
+        const Slot& current = acquire(sequence);
+        p0 = current.positions[index];
+        if (q0 && file.hasFrames()) *q0 = current.frames[index];
+
+        if (index + 1 < file.blockSamples(blockOf(sequence))) {
+            p1 = current.positions[index + 1];
+            if (q1 && file.hasFrames()) *q1 = current.frames[index + 1];
+        }
+        else {
+            const Slot& next = acquire(sequence + 1);
+            p1 = next.positions[0];
+            if (q1 && file.hasFrames()) *q1 = next.frames[0];
+        }
+    }
+
+    /**
+     * @brief Move o cursor para a próxima amostra; ao trocar de bloco, desloca a janela.
+     */
+    void stepSample()
+    {
+        const size_t previous = blockOf(sequence);
+        if (++index < file.blockSamples(previous)) return;
+        index = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++sequence;
+        }
+        wake.notify_all();
+        if (file.blockCount() > window)
+            file.mapping().release(file.blockOffset(previous), file.bytesPerBlock());
+    }
+
+    /**
+     * @brief Thread de pré-carregamento: mantém decodificados os `window` blocos a partir do cursor.
+     */
+    void prefetchLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            // Primeira posição da janela cujo bloco ainda não está no seu slot.
+            size_t target = SIZE_MAX;
+            for (size_t seq = sequence; seq < sequence + window && target == SIZE_MAX; ++seq)
+                if (slots[seq % window].sequence != seq) target = seq;
+            if (target == SIZE_MAX) {
+                wake.wait(lock);
+                continue;
+            }
+
+            // O slot de `target` guarda um bloco que já saiu da janela: a thread principal não o lê.
+            Slot& slot = slots[target % window];
+            slot.sequence = target;
+            slot.ready = false;
+            lock.unlock();
+
+            file.decodeBlock(blockOf(target), slot.positions.data(), slot.frames.empty() ? nullptr : slot.frames.data());
+            // Pede ao sistema as páginas do bloco logo após a janela.
+            file.mapping().willNeed(file.blockOffset(blockOf(target + window)), file.bytesPerBlock());
+
+            lock.lock();
+            slot.ready = true;
+            decoded.notify_all();
+        }
+    }
+
+    AnimationFile file;
+    size_t        window = 2;
+    std::vector<Slot> slots;  // O bloco da posição `seq` da sequência fica em slots[seq % window].
+
+    // Cursor de reprodução. `sequence` conta os blocos já iniciados (sem dar a volta), de modo
+    // que as posições da janela nunca disputam o mesmo slot; o bloco no arquivo é blockOf(sequence).
+    // Também é lido pela thread de pré-carregamento (sob `mutex`).
+    size_t sequence = 0;
+    size_t index = 0;              // Amostra dentro do bloco.
+    float  segmentDistance = 0.0f; // Distância percorrida dentro do segmento atual.
+
+    std::mutex              mutex;
+    std::condition_variable wake;    // Acorda a thread de pré-carregamento (cursor mudou de bloco).
+    std::condition_variable decoded; // Avisa a thread principal que um bloco ficou pronto.
+    std::thread             worker;
+    bool                    stop = false;
+    std::atomic<size_t>     stallCount{ 0 };
+};
+
+#endif // ANIMATIONSTREAM_HPP
@@ -0,0 +1,185 @@
+#ifndef ARCLENGTH_HPP
+#define ARCLENGTH_HPP
+
+// Includes padrão do C++ e da biblioteca GLM para matemática de vetores e matrizes.
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// ----------------------------------------------------------------------------
+// TABELA DE COMPRIMENTO DE ARCO (B-SPLINE CÚBICA UNIFORME)
+// ----------------------------------------------------------------------------
+
+/**
+ * @struct ArcLengthTable
+ * @brief Reparametriza uma B-Spline cúbica uniforme pela distância percorrida.
+ * @details `generateBSplinePoints` amostra a curva em passos uniformes do parâmetro t,
+ * o que NÃO corresponde a passos uniformes de distância: os pontos se aglomeram nos
+ * trechos "lentos" da curva. Esta tabela guarda, para cada segmento, os coeficientes
+ * polinomiais P(t) = a*t^3 + b*t^2 + c*t + d e o comprimento acumulado em nós
+ * igualmente espaçados de t (integrado com Gauss-Legendre de 5 pontos).
+ * Uma consulta por distância faz uma busca binária nos nós (O(log n)) e refina o
+ * parâmetro dentro do intervalo encontrado com algumas iterações de Newton.
+ */
+struct ArcLengthTable {
+    // Coeficientes de cada segmento (colunas: t^3, t^2, t, 1), i.e. G * BSplineMatrix.
+    std::vector<glm::mat4x3> segments;
+    // Comprimento acumulado em cada nó. Há `subdivisions` intervalos por segmento,
+    // e nós vizinhos entre segmentos são compartilhados: size = segmentos * subdivisions + 1.
+    std::vector<float>       cumulative;
+    // Número de intervalos de integração por segmento (resolução da tabela).
+    int                      subdivisions = 8;
+
+    ArcLengthTable() = default;
+
+    /**
+     * @brief Constrói a tabela a partir dos pontos de controle da B-Spline.
+     * @param controlPoints Pontos de controle (mínimo de 4, como em generateBSplinePoints).
+     * @param subdivisions_ Intervalos de integração por segmento.
+     */
+    ArcLengthTable(const std::vector<glm::vec3>& controlPoints, int subdivisions_ = 8)
+        : subdivisions(std::max(1, subdivisions_))
+    {
+        if (controlPoints.size() < 4)
+            return;
+
+        // Mesma matriz base usada em generateBSplinePoints.
+        const glm::mat4 BSplineMatrix(
+            -1.0f / 6.0f, 3.0f / 6.0f, -3.0f / 6.0f, 1.0f / 6.0f,
+            3.0f / 6.0f, -6.0f / 6.0f, 3.0f / 6.0f, 0.0f,
+            -3.0f / 6.0f, 0.0f, 3.0f / 6.0f, 0.0f,
+            1.0f / 6.0f, 4.0f / 6.0f, 1.0f / 6.0f, 0.0f
+        );
+
+        segments.reserve(controlPoints.size() - 3);
+        for (size_t i = 0; i + 3 < controlPoints.size(); ++i) {
+            glm::mat4x3 G(controlPoints[i],
+                controlPoints[i + 1],
+                controlPoints[i + 2],
+                controlPoints[i + 3]);
+            segments.push_back(G * BSplineMatrix);
+        }
+
+        // Integra |P'(t)| em cada intervalo e acumula.
+        cumulative.reserve(segments.size() * subdivisions + 1);
+        cumulative.push_back(0.0f);
+        const float h = 1.0f / subdivisions;
+        for (size_t seg = 0; seg < segments.size(); ++seg) {
+            for (int k = 0; k < subdivisions; ++k) {
+                float t0 = k * h;
+                cumulative.push_back(cumulative.back() + integrate(seg, t0, t0 + h));
+            }
+        }
+    }
+
+    bool  empty() const { return segments.empty(); }
+    float totalLength() const { return cumulative.empty() ? 0.0f : cumulative.back(); }
+
+    /**
+     * @brief Posição na curva após percorrer a distância `s` a partir do início.
+     * @details `s` é limitado ao intervalo [0, totalLength()].
+     */
+    glm::vec3 positionAtDistance(float s) const
+    {
+        if (empty()) return glm::vec3(0.0f);
+        size_t seg;
+        float t = parameterAtDistance(s, seg);
+        return segments[seg] * glm::vec4(t * t * t, t * t, t, 1.0f);
+    }
+
+    /**
+     * @brief Tangente unitária da curva na distância `s`.
+     */
+    glm::vec3 tangentAtDistance(float s) const
+    {
+        if (empty()) return glm::vec3(0.0f, 0.0f, 1.0f);
+        size_t seg;
+        float t = parameterAtDistance(s, seg);
+        glm::vec3 d = derivative(seg, t);
+        float len = glm::length(d);
+        // Pontos de controle repetidos podem anular a derivada; devolve um eixo fixo nesse caso.
+        return (len > 1e-6f) ? d / len : glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+
+    /**
+     * @brief Gera `count` pontos igualmente espaçados (em distância) ao longo da curva.
+     * @details Substitui a amostragem uniforme em t quando o espaçamento importa
+     * (animação com velocidade constante, vértices da pista sem superamostragem).
+     */
+    std::vector<glm::vec3> sampleEvenly(size_t count) const
+    {
+        std::vector<glm::vec3> points;
+        if (empty() || count == 0) return points;
+        points.reserve(count);
+        if (count == 1) {
+            points.push_back(positionAtDistance(0.0f));
+            return points;
+        }
+        const float spacing = totalLength() / static_cast<float>(count - 1);
+        for (size_t i = 0; i < count; ++i)
+            points.push_back(positionAtDistance(spacing * static_cast<float>(i)));
+        return points;
+    }
+
+    /**
+     * @brief Inverte a tabela: encontra o segmento e o parâmetro local t para a distância `s`.
+     * @param s Distância ao longo da curva.
+     * @param[out] seg Índice do segmento encontrado.
+     * @return Parâmetro local t em [0, 1] dentro do segmento.
+     */
+    float parameterAtDistance(float s, size_t& seg) const
+    {
+        s = glm::clamp(s, 0.0f, totalLength());
+
+        // Busca binária pelo intervalo [cumulative[k], cumulative[k+1]) que contém s.
+        size_t k = static_cast<size_t>(std::upper_bound(cumulative.begin(), cumulative.end(), s) - cumulative.begin());
+        k = (k == 0) ? 0 : k - 1;
+        const size_t lastInterval = cumulative.size() - 2;
+        if (k > lastInterval) k = lastInterval;
+
+        seg = k / subdivisions;
+        const float h = 1.0f / subdivisions;
+        const float t0 = static_cast<float>(k % subdivisions) * h;
+        const float t1 = t0 + h;
+
+        // Chute inicial por interpolação linear dentro do intervalo, refinado por Newton:
+        // f(t) = L(t0, t) - alvo, f'(t) = |P'(t)|.
+        const float target = s - cumulative[k];
+        const float span = cumulative[k + 1] - cumulative[k];
+        float t = (span > 0.0f) ? t0 + h * (target / span) : t0;
+        for (int it = 0; it < 4; ++it) {
+            float speed = glm::length(derivative(seg, t));
+            if (speed <= 1e-6f) break;
+            t = glm::clamp(t - (integrate(seg, t0, t) - target) / speed, t0, t1);
+        }
+        return t;
+    }
+
+    /**
+     * @brief Derivada P'(t) do segmento `seg`.
+     */
+    glm::vec3 derivative(size_t seg, float t) const
+    {
+        return segments[seg] * glm::vec4(3.0f * t * t, 2.0f * t, 1.0f, 0.0f);
+    }
+
+    /**
+     * @brief Comprimento de arco do segmento `seg` entre t0 e t1 (Gauss-Legendre, 5 pontos).
+     */
+    float integrate(size_t seg, float t0, float t1) const
+    {
+        static const float nodes[5] = { 0.0f, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f };
+        static const float weights[5] = { 0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f };
+
+        const float half = 0.5f * (t1 - t0);
+        const float mid = 0.5f * (t1 + t0);
+        float sum = 0.0f;
+        for (int i = 0; i < 5; ++i)
+            sum += weights[i] * glm::length(derivative(seg, mid + half * nodes[i]));
+        return sum * half;
+    }
+};
+
+#endif // ARCLENGTH_HPP
@@ -0,0 +1,261 @@
+#ifndef BLOCKCOMPRESSION_HPP
+#define BLOCKCOMPRESSION_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// ----------------------------------------------------------------------------
+// COMPRESSÃO DE TEXTURAS EM BLOCOS (BC1 / DXT1)
+// ----------------------------------------------------------------------------
+//
+// Cada bloco de 4x4 pixels vira 8 bytes (little-endian):
+//   uint16 color0, color1 (RGB 5:6:5) e uint32 com 2 bits por pixel (pixel i nos bits 2i..2i+1),
+//   escolhendo entre color0, color1 e duas cores intermediárias (2/3 e 1/3 do caminho).
+// Com color0 <= color1 o bloco usa só uma cor intermediária e o índice 3 vale preto; o
+// codificador sempre gera color0 > color1 (quatro cores), exceto em blocos de uma cor só.
+// Os blocos seguem a ordem das linhas na memória, como em glTexImage2D: a GPU decodifica o
+// formato diretamente (GL_COMPRESSED_RGB_S3TC_DXT1_EXT), com 1/6 da memória do RGB.
+
+/**
+ * @brief Bytes de um nível de mipmap de `width` x `height` em BC1.
+ */
+inline size_t bc1LevelBytes(int width, int height)
+{
+    return size_t(std::max(1, (width + 3) / 4)) * size_t(std::max(1, (height + 3) / 4)) * 8;
+}
+
+/**
+ * @brief Número de níveis da cadeia completa de mipmaps (até 1x1).
+ */
+inline int mipLevelCount(int width, int height)
+{
+    int levels = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) ++levels;
+    return levels;
+}
+
+inline uint16_t packRGB565(const float c[3])
+{
+    const int r = std::clamp(static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+    const int g = std::clamp(static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+    const int b = std::clamp(static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+inline void unpackRGB565(uint16_t c, int out[3])
+{
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * @brief Paleta de quatro cores de um bloco (color0, color1 e as intermediárias), como a GPU a monta.
+ */
+inline void bc1Palette(uint16_t c0, uint16_t c1, int palette[4][3])
+{
+    unpackRGB565(c0, palette[0]);
+    unpackRGB565(c1, palette[1]);
+    for (int a = 0; a < 3; ++a) {
+        if (c0 > c1) {
+            palette[2][a] = (2 * palette[0][a] + palette[1][a]) / 3;
+            palette[3][a] = (palette[0][a] + 2 * palette[1][a]) / 3;
+        }
+        else {
+            palette[2][a] = (palette[0][a] + palette[1][a]) / 2;
+            palette[3][a] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Escolhe para cada pixel a cor mais próxima da paleta de (c0, c1).
+ * @return O erro quadrático total do bloco.
+ */
+inline int bc1AssignIndices(const uint8_t rgb[16][3], uint16_t c0, uint16_t c1, uint32_t& indices)
+{
+    int palette[4][3];
+    bc1Palette(c0, c1, palette);
+    indices = 0;
+    int total = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, bestError = 1 << 30;
+        for (int p = 0; p < 4; ++p) {
+            int error = 0;
+            for (int a = 0; a < 3; ++a) {
+                const int d = int(rgb[i][a]) - palette[p][a];
+                error += d * d;
+            }
+            if (error < bestError) { bestError = error; best = p; }
+        }
+        indices |= uint32_t(best) << (2 * i);
+        total += bestError;
+    }
+    return total;
+}
+
+/**
+ * @brief Codifica um bloco de 16 pixels RGB.
+ * @details Os extremos iniciais são os pixels mais distantes ao longo do eixo principal das
+ * cores do bloco (autovetor dominante da covariância, por iteração de potência). Depois, com
+ * os índices escolhidos, os extremos são recalculados por mínimos quadrados (cada pixel é uma
+ * combinação fixa dos dois) enquanto o erro diminuir.
+ */
+inline void encodeBC1Block(const uint8_t rgb[16][3], uint8_t out[8])
+{
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i)
+        for (int a = 0; a < 3; ++a) mean[a] += rgb[i][a] / 16.0f;
+    float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }; // rr, rg, rb, gg, gb, bb
+    for (int i = 0; i < 16; ++i) {
+        const float d[3] = { rgb[i][0] - mean[0], rgb[i][1] - mean[1], rgb[i][2] - mean[2] };
+        cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int it = 0; it < 8; ++it) {
+        const float next[3] = {
+            cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+            cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+            cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2] };
+        const float norm = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+        if (norm < 1e-6f) break; // Bloco de uma cor só.
+        for (int a = 0; a < 3; ++a) axis[a] = next[a] / norm;
+    }
+
+    int lo = 0, hi = 0;
+    float loDot = 1e30f, hiDot = -1e30f;
+    for (int i = 0; i < 16; ++i) {
+        const float dot = rgb[i][0] * axis[0] + rgb[i][1] * axis[1] + rgb[i][2] * axis[2];
+        if (dot < loDot) { loDot = dot; lo = i; }
+        if (dot > hiDot) { hiDot = dot; hi = i; }
+    }
+    const float hiColor[3] = { float(rgb[hi][0]), float(rgb[hi][1]), float(rgb[hi][2]) };
+    const float loColor[3] = { float(rgb[lo][0]), float(rgb[lo][1]), float(rgb[lo][2]) };
+    uint16_t c0 = packRGB565(hiColor), c1 = packRGB565(loColor);
+    if (c0 < c1) std::swap(c0, c1);
+    uint32_t indices = 0;
+    int error = (c0 != c1) ? bc1AssignIndices(rgb, c0, c1, indices) : 0;
+
+    // Refinamento: pixel i ~ w_i * A + (1 - w_i) * B, com w_i dado pelo índice (1, 0, 2/3, 1/3).
+    static const float weight[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    for (int it = 0; it < 2 && c0 != c1; ++it) {
+        float aa = 0.0f, bb = 0.0f, ab = 0.0f, ax[3] = { 0.0f, 0.0f, 0.0f }, bx[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            const float w = weight[(indices >> (2 * i)) & 3], v = 1.0f - w;
+            aa += w * w; bb += v * v; ab += w * v;
+            for (int a = 0; a < 3; ++a) { ax[a] += w * rgb[i][a]; bx[a] += v * rgb[i][a]; }
+        }
+        const float det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f) break;
+        float A[3], B[3];
+        for (int a = 0; a < 3; ++a) {
+            A[a] = std::clamp((ax[a] * bb - bx[a] * ab) / det, 0.0f, 255.0f);
+            B[a] = std::clamp((bx[a] * aa - ax[a] * ab) / det, 0.0f, 255.0f);
+        }
+        uint16_t n0 = packRGB565(A), n1 = packRGB565(B);
+        if (n0 < n1) std::swap(n0, n1);
+        if (n0 == n1 || (n0 == c0 && n1 == c1)) break;
+        uint32_t candidate = 0;
+        const int candidateError = bc1AssignIndices(rgb, n0, n1, candidate);
+        if (candidateError >= error) break;
+        c0 = n0; c1 = n1; indices = candidate; error = candidateError;
+    }
+
+    std::memcpy(out, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+/**
+ * @brief Codifica uma imagem inteira (um nível). Nas bordas, os blocos repetem o último pixel.
+ * @param pixels `channels` bytes por pixel (3 ou 4; o alfa é ignorado), linhas sem preenchimento.
+ * @param out bc1LevelBytes(width, height) bytes.
+ */
+inline void encodeBC1(const uint8_t* pixels, int width, int height, int channels, uint8_t* out)
+{
+    uint8_t block[16][3];
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            for (int i = 0; i < 16; ++i) {
+                const int x = std::min(bx + i % 4, width - 1), y = std::min(by + i / 4, height - 1);
+                std::memcpy(block[i], pixels + (size_t(y) * width + x) * channels, 3);
+            }
+            encodeBC1Block(block, out);
+            out += 8;
+        }
+    }
+}
+
+/**
+ * @brief Decodifica um nível BC1 para RGB (3 bytes por pixel, linhas sem preenchimento).
+ * @details Usado quando o driver não aceita o formato comprimido.
+ */
+inline void decodeBC1(const uint8_t* blocks, int width, int height, uint8_t* rgb)
+{
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            uint16_t c0, c1;
+            uint32_t indices;
+            std::memcpy(&c0, blocks, 2);
+            std::memcpy(&c1, blocks + 2, 2);
+            std::memcpy(&indices, blocks + 4, 4);
+            blocks += 8;
+            int palette[4][3];
+            bc1Palette(c0, c1, palette);
+            for (int i = 0; i < 16; ++i) {
+                const int x = bx + i % 4, y = by + i / 4;
+                if (x >= width || y >= height) continue;
+                const int* color = palette[(indices >> (2 * i)) & 3];
+                uint8_t* dst = rgb + (size_t(y) * width + x) * 3;
+                for (int a = 0; a < 3; ++a) dst[a] = static_cast<uint8_t>(color[a]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Codifica a cadeia completa de mipmaps, do nível 0 ao 1x1, concatenados nessa ordem.
+ * @details Cada nível é reduzido do anterior pela média de 2x2 pixels (com o último pixel
+ * repetido nas dimensões ímpares), como faria glGenerateMipmap, que não se aplica a texturas
+ * enviadas já comprimidas.
+ */
+inline std::vector<uint8_t> encodeBC1Mips(const uint8_t* pixels, int width, int height, int channels)
+{
+    const int levels = mipLevelCount(width, height);
+    size_t total = 0;
+    for (int l = 0, w = width, h = height; l < levels; ++l, w = std::max(1, w / 2), h = std::max(1, h / 2))
+        total += bc1LevelBytes(w, h);
+    std::vector<uint8_t> out(total);
+
+    std::vector<uint8_t> level(pixels, pixels + size_t(width) * height * channels), next;
+    uint8_t* dst = out.data();
+    for (int l = 0, w = width, h = height; l < levels; ++l) {
+        encodeBC1(level.data(), w, h, channels, dst);
+        dst += bc1LevelBytes(w, h);
+        if (l + 1 == levels) break;
+
+        const int nw = std::max(1, w / 2), nh = std::max(1, h / 2);
+        next.resize(size_t(nw) * nh * channels);
+        for (int y = 0; y < nh; ++y)
+            for (int x = 0; x < nw; ++x)
+                for (int a = 0; a < channels; ++a) {
+                    const int x0 = std::min(2 * x, w - 1), x1 = std::min(2 * x + 1, w - 1);
+                    const int y0 = std::min(2 * y, h - 1), y1 = std::min(2 * y + 1, h - 1);
+                    const int sum = level[(size_t(y0) * w + x0) * channels + a] + level[(size_t(y0) * w + x1) * channels + a]
+                        + level[(size_t(y1) * w + x0) * channels + a] + level[(size_t(y1) * w + x1) * channels + a];
+                    next[(size_t(y) * nw + x) * channels + a] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+        level.swap(next);
+        w = nw;
+        h = nh;
+    }
+    return out;
+}
+
+#endif // BLOCKCOMPRESSION_HPP
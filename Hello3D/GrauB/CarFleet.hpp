@@ -0,0 +1,270 @@
+#ifndef CARFLEET_HPP
+#define CARFLEET_HPP
+
+#include "AnimationPath.hpp" // Trajetória (pontos, comprimento de arco e referenciais) seguida pelos carros.
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+
+// SSE2 está sempre disponível em x64 (e em x86 com /arch:SSE2); fora disso, usa o caminho escalar.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CARFLEET_SSE 1
+#include <emmintrin.h>
+#else
+#define CARFLEET_SSE 0
+#endif
+
+// ----------------------------------------------------------------------------
+// FROTA DE CARROS ANIMADOS EM LOTE (SoA + SIMD)
+// ----------------------------------------------------------------------------
+
+/**
+ * @struct CarFleet
+ * @brief Atualiza, em lote, milhares de carros que seguem a mesma trajetória gravada.
+ * @details Em vez de montar a matriz de cada Object3D com várias chamadas a
+ * glm::translate/rotate/scale, o estado da frota fica em arrays separados por campo
+ * (Structure of Arrays): distância percorrida, deslocamento lateral (faixa), velocidade.
+ * A trajetória também é guardada em SoA (posição e eixos do referencial de cada amostra).
+ * A atualização tem duas passadas:
+ *  1. escalar: avança a distância de cada carro e o segmento onde ela cai (O(1) amortizado);
+ *  2. vetorizada: 4 carros por vez (SSE2), interpola posição e eixos entre as amostras do
+ *     segmento, aplica a faixa e a escala e escreve as matrizes de modelo em `matrices`,
+ *     um buffer contíguo pronto para ser enviado como atributo de instância.
+ */
+struct CarFleet {
+    // --- Trajetória (SoA). Há n + 1 amostras: a última repete a primeira para fechar o laço. ---
+    std::vector<float> px, py, pz;    // Posição.
+    std::vector<float> sx, sy, sz;    // Eixo lateral do referencial (X).
+    std::vector<float> ux, uy, uz;    // Eixo "cima" (Y).
+    std::vector<float> fx, fy, fz;    // Eixo "frente" (Z).
+    std::vector<float> cumulative;    // Distância até cada amostra.
+    float              pathLength = 0.0f;
+
+    // --- Estado dos carros (SoA). ---
+    std::vector<float>    distance;   // Distância percorrida na trajetória.
+    std::vector<float>    laneOffset; // Deslocamento ao longo do eixo lateral.
+    std::vector<float>    speed;      // Unidades por segundo.
+    std::vector<uint32_t> segment;    // Segmento atual (cursor).
+    std::vector<float>    fraction;   // Posição dentro do segmento [0, 1] (saída da passada 1).
+
+    float                  scale = 1.0f; // Escala uniforme aplicada a todos os carros.
+    std::vector<glm::mat4> matrices;     // Saída: matriz de modelo de cada carro.
+
+    /**
+     * @brief Copia a trajetória (pontos e referenciais pré-calculados) para o layout SoA.
+     */
+    void setPath(const AnimationPath& path)
+    {
+        const size_t n = path.points.size();
+        const size_t count = n ? n + 1 : 0;
+        for (auto* v : { &px, &py, &pz, &sx, &sy, &sz, &ux, &uy, &uz, &fx, &fy, &fz })
+            v->resize(count);
+        cumulative.assign(path.cumulative.begin(), path.cumulative.end());
+        pathLength = path.length();
+
+        for (size_t k = 0; k < count; ++k) {
+            const size_t i = k % n;
+            const glm::mat3 frame = glm::mat3_cast(path.frames[i]);
+            px[k] = path.points[i].x; py[k] = path.points[i].y; pz[k] = path.points[i].z;
+            sx[k] = frame[0].x;       sy[k] = frame[0].y;       sz[k] = frame[0].z;
+            ux[k] = frame[1].x;       uy[k] = frame[1].y;       uz[k] = frame[1].z;
+            fx[k] = frame[2].x;       fy[k] = frame[2].y;       fz[k] = frame[2].z;
+        }
+    }
+
+    size_t size() const { return distance.size(); }
+
+    /**
+     * @brief Adiciona um carro e devolve seu índice.
+     */
+    size_t addCar(float startDistance, float lane, float carSpeed)
+    {
+        distance.push_back(startDistance);
+        laneOffset.push_back(lane);
+        speed.push_back(carSpeed);
+        segment.push_back(0);
+        fraction.push_back(0.0f);
+        matrices.emplace_back(1.0f);
+        return distance.size() - 1;
+    }
+
+    /**
+     * @brief Avança todos os carros por `dt` segundos e recalcula suas matrizes de modelo.
+     * @param useSimd Permite forçar o caminho escalar (usado pelo benchmark para comparação).
+     */
+    void update(float dt, bool useSimd = true)
+    {
+        if (pathLength <= 0.0f) return;
+        advance(dt);
+
+        size_t first = 0;
+#if CARFLEET_SSE
+        if (useSimd) {
+            for (; first + 4 <= size(); first += 4)
+                buildMatricesSse(first);
+        }
+#endif
+        for (size_t c = first; c < size(); ++c)
+            buildMatrixScalar(c);
+    }
+
+private:
+    /**
+     * @brief Passada 1 (escalar): distância, segmento e fração dentro do segmento.
+     */
+    void advance(float dt)
+    {
+        const uint32_t last = static_cast<uint32_t>(cumulative.size() - 2);
+        for (size_t c = 0; c < size(); ++c) {
+            float d = distance[c] + speed[c] * dt;
+            uint32_t seg = segment[c];
+            if (d >= pathLength || d < 0.0f) {
+                d = std::fmod(d, pathLength);
+                if (d < 0.0f) d += pathLength;
+                seg = (speed[c] >= 0.0f) ? 0 : last;
+            }
+            while (seg < last && cumulative[seg + 1] <= d) ++seg;
+            while (seg > 0 && cumulative[seg] > d) --seg;
+
+            const float span = cumulative[seg + 1] - cumulative[seg];
+            distance[c] = d;
+            segment[c] = seg;
+            fraction[c] = (span > 0.0f) ? glm::clamp((d - cumulative[seg]) / span, 0.0f, 1.0f) : 0.0f;
+        }
+    }
+
+    /**
+     * @brief Passada 2 (escalar): mesma matemática do caminho SSE, um carro por vez.
+     */
+    void buildMatrixScalar(size_t c)
+    {
+        const uint32_t i = segment[c];
+        const uint32_t j = i + 1;
+        const float f = fraction[c];
+
+        auto lerp3 = [f, i, j](const std::vector<float>& X, const std::vector<float>& Y, const std::vector<float>& Z) {
+            return glm::vec3(X[i] + (X[j] - X[i]) * f, Y[i] + (Y[j] - Y[i]) * f, Z[i] + (Z[j] - Z[i]) * f);
+        };
+        const glm::vec3 side = glm::normalize(lerp3(sx, sy, sz));
+        const glm::vec3 up = glm::normalize(lerp3(ux, uy, uz));
+        const glm::vec3 fwd = glm::normalize(lerp3(fx, fy, fz));
+        const glm::vec3 pos = lerp3(px, py, pz) + side * laneOffset[c];
+
+        glm::mat4& m = matrices[c];
+        m[0] = glm::vec4(side * scale, 0.0f);
+        m[1] = glm::vec4(up * scale, 0.0f);
+        m[2] = glm::vec4(fwd * scale, 0.0f);
+        m[3] = glm::vec4(pos, 1.0f);
+    }
+
+#if CARFLEET_SSE
+    // Carrega X[idx[0..3]] em um registrador (gather escalar; SSE2 não tem gather).
+    static __m128 gather(const std::vector<float>& X, const uint32_t* idx)
+    {
+        return _mm_setr_ps(X[idx[0]], X[idx[1]], X[idx[2]], X[idx[3]]);
+    }
+
+    // Interpola X entre as amostras i e j dos 4 carros: X[i] + (X[j] - X[i]) * f.
+    static __m128 lerp(const std::vector<float>& X, const uint32_t* i, const uint32_t* j, __m128 f)
+    {
+        const __m128 a = gather(X, i);
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(gather(X, j), a), f));
+    }
+
+    // Normaliza 4 vetores em SoA e aplica um fator de escala.
+    static void normalizeScale(__m128& x, __m128& y, __m128& z, __m128 s)
+    {
+        const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        const __m128 k = _mm_div_ps(s, _mm_sqrt_ps(len2));
+        x = _mm_mul_ps(x, k);
+        y = _mm_mul_ps(y, k);
+        z = _mm_mul_ps(z, k);
+    }
+
+    // Transpõe as coordenadas SoA (x, y, z, w) de uma coluna e grava a coluna `col` das 4 matrizes.
+    void storeColumn(size_t first, int col, __m128 x, __m128 y, __m128 z, __m128 w)
+    {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(&matrices[first + 0][col][0], x);
+        _mm_storeu_ps(&matrices[first + 1][col][0], y);
+        _mm_storeu_ps(&matrices[first + 2][col][0], z);
+        _mm_storeu_ps(&matrices[first + 3][col][0], w);
+    }
+
+    /**
+     * @brief Passada 2 (SSE2): matrizes de modelo dos carros first..first+3.
+     */
+    void buildMatricesSse(size_t first)
+    {
+        const uint32_t* i = &segment[first];
+        const uint32_t j[4] = { i[0] + 1, i[1] + 1, i[2] + 1, i[3] + 1 };
+        const __m128 f = _mm_loadu_ps(&fraction[first]);
+        const __m128 s = _mm_set1_ps(scale);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 sX = lerp(sx, i, j, f), sY = lerp(sy, i, j, f), sZ = lerp(sz, i, j, f);
+        __m128 uX = lerp(ux, i, j, f), uY = lerp(uy, i, j, f), uZ = lerp(uz, i, j, f);
+        __m128 fX = lerp(fx, i, j, f), fY = lerp(fy, i, j, f), fZ = lerp(fz, i, j, f);
+        normalizeScale(sX, sY, sZ, one);
+
+        // Posição: ponto interpolado + eixo lateral (unitário) * faixa.
+        const __m128 lane = _mm_loadu_ps(&laneOffset[first]);
+        const __m128 pX = _mm_add_ps(lerp(px, i, j, f), _mm_mul_ps(sX, lane));
+        const __m128 pY = _mm_add_ps(lerp(py, i, j, f), _mm_mul_ps(sY, lane));
+        const __m128 pZ = _mm_add_ps(lerp(pz, i, j, f), _mm_mul_ps(sZ, lane));
+
+        sX = _mm_mul_ps(sX, s); sY = _mm_mul_ps(sY, s); sZ = _mm_mul_ps(sZ, s);
+        normalizeScale(uX, uY, uZ, s);
+        normalizeScale(fX, fY, fZ, s);
+
+        storeColumn(first, 0, sX, sY, sZ, zero);
+        storeColumn(first, 1, uX, uY, uZ, zero);
+        storeColumn(first, 2, fX, fY, fZ, zero);
+        storeColumn(first, 3, pX, pY, pZ, one);
+    }
+#endif
+};
+
+/**
+ * @brief Microbenchmark da frota: mede quantas matrizes de modelo por segundo são geradas.
+ * @details Usa uma trajetória sintética (laço com elevação) e carros espalhados por ela, e
+ * compara o caminho escalar com o vetorizado. Executado com `--bench-fleet [carros] [frames]`.
+ */
+static void runCarFleetBenchmark(size_t carCount, int frames)
+{
+    std::vector<glm::vec3> loop;
+    const int samples = 4096;
+    for (int k = 0; k < samples; ++k) {
+        float a = 6.2831853f * k / samples;
+        loop.emplace_back(200.0f * std::cos(a), 5.0f * std::sin(3.0f * a), 120.0f * std::sin(a));
+    }
+    AnimationPath path(loop);
+
+    CarFleet fleet;
+    fleet.setPath(path);
+    fleet.scale = 0.5f;
+    for (size_t c = 0; c < carCount; ++c)
+        fleet.addCar(path.length() * c / carCount, (c % 3) - 1.0f, 20.0f + (c % 7));
+
+    const float dt = 1.0f / 60.0f;
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool simd = (pass == 1);
+        fleet.update(dt, simd); // aquecimento
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+            fleet.update(dt, simd);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double perSecond = (seconds > 0.0) ? (double(carCount) * frames) / seconds : 0.0;
+        std::printf("%-8s %zu carros x %d frames: %.3f ms/frame, %.2f M matrizes/s\n",
+            simd ? (CARFLEET_SSE ? "SSE2" : "escalar") : "escalar",
+            carCount, frames, 1000.0 * seconds / frames, perSecond / 1e6);
+    }
+}
+
+#endif // CARFLEET_HPP
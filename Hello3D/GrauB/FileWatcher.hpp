@@ -0,0 +1,219 @@
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <cstdint>
+
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// OBSERVAÇÃO DE ARQUIVOS (HOT RELOAD)
+// ----------------------------------------------------------------------------
+
+// Intervalo entre verificações quando não há inotify.
+const std::chrono::milliseconds FILEWATCH_POLL_INTERVAL(500);
+// Tempo que um arquivo modificado precisa ficar sem mudar antes de ser relatado.
+const std::chrono::milliseconds FILEWATCH_SETTLE_TIME(200);
+
+/**
+ * @class FileWatcher
+ * @brief Detecta modificações em um conjunto de arquivos, para recarregá-los sem reiniciar.
+ * @details No Linux usa inotify nos diretórios dos arquivos (editores costumam salvar gravando
+ * um arquivo novo e renomeando, o que invalidaria um watch no próprio arquivo): só os arquivos
+ * citados em eventos são verificados. Nas demais plataformas, ou se o inotify falhar, verifica
+ * todos os arquivos a cada FILEWATCH_POLL_INTERVAL.
+ * Uma modificação só é relatada quando o arquivo fica estável (mesma data e tamanho) por
+ * FILEWATCH_SETTLE_TIME, para não ler um arquivo ainda sendo gravado.
+ */
+class FileWatcher {
+public:
+    FileWatcher()
+    {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    ~FileWatcher()
+    {
+#ifdef __linux__
+        if (inotifyFd >= 0) ::close(inotifyFd);
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Passa a observar exatamente `paths` (substitui o conjunto anterior).
+     * @details O estado atual de cada arquivo vira a referência: só mudanças posteriores são relatadas.
+     */
+    void watch(const std::vector<std::string>& paths)
+    {
+        files.clear();
+        for (const auto& path : paths)
+            if (!path.empty()) files[path].baseline = stampOf(path);
+#ifdef __linux__
+        if (inotifyFd >= 0) {
+            for (const auto& wd : directoryWatches)
+                inotify_rm_watch(inotifyFd, wd.first);
+            directoryWatches.clear();
+            std::unordered_set<std::string> directories;
+            for (const auto& entry : files)
+                directories.insert(directoryOf(entry.first));
+            for (const auto& dir : directories) {
+                int wd = inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+                if (wd >= 0) directoryWatches[wd] = dir;
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Adota o estado atual dos arquivos como referência, descartando mudanças pendentes
+     * (por exemplo, as que a própria aplicação acabou de gravar).
+     */
+    void rebaseline()
+    {
+        drainEvents();
+        for (auto& entry : files) {
+            entry.second.baseline = stampOf(entry.first);
+            entry.second.pending = false;
+        }
+    }
+
+    /**
+     * @brief Arquivos modificados (e já estáveis) desde a última chamada.
+     */
+    std::vector<std::string> poll()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (usesInotify()) {
+            for (const auto& name : drainEvents()) {
+                auto it = files.find(name);
+                if (it != files.end()) check(it->first, it->second, now);
+            }
+        }
+        else if (now - lastScan >= FILEWATCH_POLL_INTERVAL) {
+            lastScan = now;
+            for (auto& entry : files) check(entry.first, entry.second, now);
+        }
+
+        std::vector<std::string> changed;
+        for (auto& entry : files) {
+            Watched& file = entry.second;
+            if (!file.pending) continue;
+            // Ainda mudando: reinicia a espera.
+            check(entry.first, file, now);
+            if (file.pending && now - file.pendingSince >= FILEWATCH_SETTLE_TIME) {
+                file.baseline = file.candidate;
+                file.pending = false;
+                changed.push_back(entry.first);
+            }
+        }
+        return changed;
+    }
+
+    bool usesInotify() const
+    {
+#ifdef __linux__
+        return inotifyFd >= 0;
+#else
+        return false;
+#endif
+    }
+
+private:
+    // Identifica uma versão do arquivo: data de modificação e tamanho (-1 = não existe).
+    struct Stamp {
+        int64_t modified = 0;
+        int64_t size = -1;
+        bool operator==(const Stamp& o) const { return modified == o.modified && size == o.size; }
+        bool operator!=(const Stamp& o) const { return !(*this == o); }
+    };
+
+    struct Watched {
+        Stamp baseline;            // Versão já relatada (ou a inicial).
+        Stamp candidate;           // Versão nova, esperando ficar estável.
+        bool  pending = false;
+        std::chrono::steady_clock::time_point pendingSince;
+    };
+
+    void check(const std::string& path, Watched& file, std::chrono::steady_clock::time_point now)
+    {
+        const Stamp current = stampOf(path);
+        if (current == file.baseline) {
+            file.pending = false;
+        }
+        else if (!file.pending || current != file.candidate) {
+            file.pending = true;
+            file.candidate = current;
+            file.pendingSince = now;
+        }
+    }
+
+    static Stamp stampOf(const std::string& path)
+    {
+        Stamp stamp;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return stamp;
+#ifdef __linux__
+        stamp.modified = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+        stamp.modified = static_cast<int64_t>(st.st_mtime);
+#endif
+        stamp.size = static_cast<int64_t>(st.st_size);
+        return stamp;
+    }
+
+    static std::string directoryOf(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        return (slash == std::string::npos) ? "." : path.substr(0, slash);
+    }
+
+    /**
+     * @brief Lê os eventos pendentes do inotify e devolve os caminhos dos arquivos citados.
+     */
+    std::vector<std::string> drainEvents()
+    {
+        std::vector<std::string> names;
+#ifdef __linux__
+        if (inotifyFd < 0) return names;
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) break;
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                auto dir = directoryWatches.find(event->wd);
+                if (event->len > 0 && dir != directoryWatches.end()) {
+                    // Mesmo formato dos caminhos passados a watch(): sem "./" para o diretório atual.
+                    names.push_back(dir->second == "." ? std::string(event->name) : dir->second + "/" + event->name);
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+#endif
+        return names;
+    }
+
+    std::unordered_map<std::string, Watched> files;
+    std::chrono::steady_clock::time_point    lastScan;
+#ifdef __linux__
+    int inotifyFd = -1;
+    std::unordered_map<int, std::string> directoryWatches; // wd -> diretório.
+#endif
+};
+
+#endif // FILEWATCHER_HPP
@@ -20,8 +20,22 @@
 #include <cassert>
 #include <algorithm>
 #include <array>
+#include <memory>
+#include <string_view>
+#include <charconv>
+#include <memory_resource>
 #include <glad/glad.h> // GLAD para carregar ponteiros de funções do OpenGL.
 
+#include "AnimationPath.hpp" // Trajetória de animação parametrizada por distância.
+#include "AnimationStream.hpp" // Reprodução em streaming de gravações longas (.anim).
+#include "ScratchArena.hpp"    // Arena para os dados temporários da leitura dos arquivos.
+#include "BlockCompression.hpp" // Texturas comprimidas em BC1 (pacotes de cena).
+#include "../../Common/include/Profiler.hpp" // Zonas de tempo de CPU (leitura de .obj e .mtl).
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0 // GL_EXT_texture_compression_s3tc (fora do núcleo).
+#endif
+
 // ----------------------------------------------------------------------------
 // ESTRUTURAS AUXILIARES DE GEOMETRIA
 // ----------------------------------------------------------------------------
@@ -82,6 +96,7 @@ struct Group {
         : name(_name), mtlName(_mtl) {}
 
     void addFace(const Face& f) { faces.push_back(f); }
+    void addFace(Face&& f) { faces.push_back(std::move(f)); }
 };
 
 // ----------------------------------------------------------------------------
@@ -125,6 +140,60 @@ struct Material {
     std::string textureName;
 };
 
+// ----------------------------------------------------------------------------
+// LEITURA DE ARQUIVOS DE TEXTO (.obj, .mtl, cena)
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Converte `text` inteiro em número. Se não for um número válido, `value` não muda.
+ */
+template <typename T>
+static bool parseNumber(std::string_view text, T& value)
+{
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc();
+}
+
+/**
+ * @struct LineScanner
+ * @brief Lê os campos, separados por espaços, de uma linha de texto sem alocar memória.
+ * @details Substitui o `std::istringstream` criado a cada linha, que copiava a linha e alocava
+ * a cada uso. Os tokens são `std::string_view` da própria linha. Como no stream, os campos são
+ * lidos com `>>`; um campo ausente ou inválido deixa o valor de destino como estava.
+ */
+struct LineScanner {
+    std::string_view rest; // O que ainda não foi lido da linha.
+
+    explicit LineScanner(std::string_view line) : rest(line) {}
+
+    /**
+     * @brief O próximo campo da linha ("" no fim da linha).
+     */
+    std::string_view token()
+    {
+        const size_t begin = rest.find_first_not_of(" \t\r\n");
+        if (begin == std::string_view::npos) {
+            rest = std::string_view();
+            return rest;
+        }
+        size_t end = rest.find_first_of(" \t\r\n", begin);
+        if (end == std::string_view::npos) end = rest.size();
+        const std::string_view field = rest.substr(begin, end - begin);
+        rest.remove_prefix(end);
+        return field;
+    }
+
+    LineScanner& operator>>(float& value) { parseNumber(token(), value); return *this; }
+    LineScanner& operator>>(int& value) { parseNumber(token(), value); return *this; }
+    LineScanner& operator>>(unsigned int& value) { parseNumber(token(), value); return *this; }
+    LineScanner& operator>>(std::string& value)
+    {
+        const std::string_view field = token();
+        if (!field.empty()) value.assign(field);
+        return *this;
+    }
+};
+
 // ----------------------------------------------------------------------------
 // FUNÇÕES AUXILIARES DE SETUP (OPENGL)
 // ----------------------------------------------------------------------------
@@ -136,6 +205,7 @@ struct Material {
  */
 static Material setupMtl(const std::string& path)
 {
+    PROFILE_ZONE("setupMtl");
     Material material{};
     std::ifstream file(path);
     std::string line;
@@ -147,9 +217,8 @@ static Material setupMtl(const std::string& path)
 
     // Lê o arquivo linha por linha
     while (std::getline(file, line)) {
-        std::istringstream ss(line);
-        std::string type;
-        ss >> type; // O primeiro token da linha define o tipo de dado (e.g., "Ka", "Kd").
+        LineScanner ss(line);
+        const std::string_view type = ss.token(); // O primeiro token da linha define o tipo de dado (e.g., "Ka", "Kd").
 
         // Preenche a struct material com base no tipo
         if (type == "Ka")
@@ -169,11 +238,92 @@ static Material setupMtl(const std::string& path)
 }
 
 /**
- * @brief Carrega um arquivo de imagem e cria uma textura OpenGL.
- * @param filename O caminho para o arquivo de imagem.
+ * @struct TextureImage
+ * @brief Imagem decodificada em memória (RAM), ainda não enviada à GPU.
+ * @details Os pixels são compartilhados porque a imagem viaja dentro do Object3D, que é copiado.
+ * Vinda de um pacote de cena, a imagem aponta direto para o arquivo mapeado: os pixels (ou os
+ * blocos BC1) mantêm o pacote vivo até o envio.
+ */
+struct TextureImage {
+    int width = 0, height = 0, channels = 0;
+    std::shared_ptr<unsigned char> pixels; // Liberados com stbi_image_free.
+    // Alternativa a `pixels`: cadeia de `mipLevels` mipmaps em BC1, do nível 0 ao 1x1.
+    std::shared_ptr<const uint8_t> bc1Mips;
+    int mipLevels = 0;
+
+    bool valid() const { return pixels != nullptr || bc1Mips != nullptr; }
+};
+
+/**
+ * @brief Lê e decodifica um arquivo de imagem, sem usar o OpenGL (pode rodar em qualquer thread).
+ * @details A stb_image carrega imagens com a origem no canto superior esquerdo, enquanto o
+ * OpenGL espera a origem no canto inferior esquerdo, então as linhas são invertidas aqui.
+ * A inversão não usa `stbi_set_flip_vertically_on_load`, que é um estado global da biblioteca
+ * e seria compartilhado entre decodificações simultâneas.
+ * @return A imagem; `valid()` é false se o arquivo não pôde ser lido.
+ */
+static TextureImage decodeTexture(const std::string& filename)
+{
+    TextureImage image;
+    unsigned char* data = stbi_load(filename.c_str(), &image.width, &image.height, &image.channels, 0);
+    if (!data) {
+        std::cerr << "Falha ao carregar a textura: " << filename << std::endl;
+        return image;
+    }
+    image.pixels.reset(data, stbi_image_free);
+
+    const size_t rowBytes = static_cast<size_t>(image.width) * image.channels;
+    for (int top = 0, bottom = image.height - 1; top < bottom; ++top, --bottom)
+        std::swap_ranges(data + top * rowBytes, data + (top + 1) * rowBytes, data + bottom * rowBytes);
+    return image;
+}
+
+/**
+ * @brief Verifica se o driver aceita texturas BC1 (DXT1) comprimidas.
+ * @details Deve ser chamada na thread dona do contexto OpenGL.
+ */
+static bool supportsBC1()
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    std::vector<GLint> formats(std::max(count, 0));
+    if (count > 0) glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+    return std::find(formats.begin(), formats.end(), GLint(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)) != formats.end();
+}
+
+/**
+ * @brief Envia a cadeia de mipmaps BC1 da imagem para a textura vinculada.
+ * @details Os blocos vão como estão para a GPU; se o driver não aceitar o formato, cada nível
+ * é decodificado para RGB antes do envio.
+ */
+static void uploadBC1Mips(const TextureImage& image)
+{
+    static const bool hardwareBC1 = supportsBC1();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.mipLevels - 1);
+    const uint8_t* level = image.bc1Mips.get();
+    std::vector<uint8_t> rgb;
+    if (!hardwareBC1) glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Níveis pequenos têm linhas de tamanho ímpar.
+    for (int l = 0, w = image.width, h = image.height; l < image.mipLevels; ++l, w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+        const size_t bytes = bc1LevelBytes(w, h);
+        if (hardwareBC1) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, l, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, w, h, 0, static_cast<GLsizei>(bytes), level);
+        }
+        else {
+            rgb.resize(size_t(w) * h * 3);
+            decodeBC1(level, w, h, rgb.data());
+            glTexImage2D(GL_TEXTURE_2D, l, GL_RGB, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+        }
+        level += bytes;
+    }
+    if (!hardwareBC1) glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+/**
+ * @brief Cria uma textura OpenGL a partir de uma imagem já decodificada.
+ * @details Se a imagem for inválida, a textura é criada vazia (como quando o arquivo não existe).
  * @return O ID da textura OpenGL gerada.
  */
-static GLuint setupTexture(const std::string& filename)
+static GLuint uploadTexture(const TextureImage& image)
 {
     GLuint texId;
     glGenTextures(1, &texId); // Gera um ID de textura
@@ -186,36 +336,38 @@ static GLuint setupTexture(const std::string& filename)
     // GL_LINEAR_MIPMAP_LINEAR usa mipmaps para minificação (melhor qualidade) e interpolação linear para magnificação.
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    // A biblioteca stb_image carrega imagens com a origem no canto superior esquerdo,
-    // enquanto o OpenGL espera a origem no canto inferior esquerdo. Esta linha corrige isso.
-    stbi_set_flip_vertically_on_load(true);
-
-    int w, h, channels;
-    // Carrega os dados da imagem do arquivo para a memória RAM.
-    unsigned char* data = stbi_load(filename.c_str(), &w, &h, &channels, 0);
-    if (data) {
+
+    if (image.bc1Mips) {
+        // Já comprimida e com os mipmaps prontos (pacote de cena).
+        uploadBC1Mips(image);
+    }
+    else if (image.valid()) {
         // Determina o formato da imagem (RGB ou RGBA)
-        GLenum fmt = (channels == 3 ? GL_RGB : GL_RGBA);
+        GLenum fmt = (image.channels == 3 ? GL_RGB : GL_RGBA);
         // Envia os dados da imagem da RAM para a VRAM (memória da GPU)
-        glTexImage2D(GL_TEXTURE_2D, 0, fmt, w, h, 0, fmt, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, 0, fmt, image.width, image.height, 0, fmt, GL_UNSIGNED_BYTE, image.pixels.get());
         // Gera mipmaps automaticamente para a textura.
         glGenerateMipmap(GL_TEXTURE_2D);
     }
-    else {
-        std::cerr << "Falha ao carregar a textura: " << filename << std::endl;
-    }
-    // Libera a memória da RAM usada para carregar a imagem.
-    stbi_image_free(data);
     return texId;
 }
 
+/**
+ * @brief Carrega um arquivo de imagem e cria uma textura OpenGL.
+ * @param filename O caminho para o arquivo de imagem.
+ * @return O ID da textura OpenGL gerada.
+ */
+static GLuint setupTexture(const std::string& filename)
+{
+    return uploadTexture(decodeTexture(filename));
+}
+
 /**
  * @brief Cria e configura um Vertex Array Object (VAO) e um Vertex Buffer Object (VBO).
  * @param vertices Um vetor de vértices com dados intercalados (posição, UV, normal).
  * @return O ID do VAO configurado.
  */
-static GLuint setupGeometry(const std::vector<Vertex>& vertices)
+static GLuint setupGeometry(const Vertex* vertices, size_t vertexCount)
 {
     GLuint VBO, VAO;
     // 1. Criar e preencher o VBO
@@ -223,7 +375,7 @@ static GLuint setupGeometry(const std::vector<Vertex>& vertices)
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     // Envia os dados do vetor de vértices para o VBO na GPU.
     // GL_STATIC_DRAW significa que os dados não serão modificados frequentemente.
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
 
     // 2. Criar e configurar o VAO
     glGenVertexArrays(1, &VAO);
@@ -259,6 +411,58 @@ static GLuint setupGeometry(const std::vector<Vertex>& vertices)
     return VAO;
 }
 
+static GLuint setupGeometry(const std::vector<Vertex>& vertices)
+{
+    return setupGeometry(vertices.data(), vertices.size());
+}
+
+/**
+ * @brief Anexa ao VAO (criado por setupGeometry) um buffer de índices (EBO).
+ * @details O VAO é desvinculado ANTES do EBO; caso contrário, perderia a referência ao EBO.
+ */
+static void attachIndexBuffer(GLuint VAO, const unsigned int* indices, size_t indexCount)
+{
+    GLuint EBO;
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/**
+ * @brief Cria o VAO/VBO como `setupGeometry(vertices)` e anexa um buffer de índices (EBO).
+ * @details O EBO fica registrado no estado do VAO, então basta vincular o VAO e chamar
+ * glDrawElements. Permite que vértices compartilhados sejam enviados uma única vez.
+ * @param vertices Um vetor de vértices com dados intercalados (posição, UV, normal).
+ * @param indices Índices dos triângulos (3 por triângulo).
+ * @return O ID do VAO configurado.
+ */
+static GLuint setupGeometry(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+    GLuint VAO = setupGeometry(vertices);
+    attachIndexBuffer(VAO, indices.data(), indices.size());
+    return VAO;
+}
+
+/**
+ * @brief Apaga um VAO junto com os buffers de vértices e de índices vinculados a ele
+ * (o inverso de setupGeometry + attachIndexBuffer).
+ */
+static void deleteVertexArrayAndBuffers(GLuint VAO)
+{
+    if (!VAO) return;
+    GLint vbo = 0, ebo = 0;
+    glBindVertexArray(VAO);
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &vbo);
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &ebo);
+    glBindVertexArray(0);
+    GLuint buffers[2] = { static_cast<GLuint>(vbo), static_cast<GLuint>(ebo) };
+    glDeleteBuffers(2, buffers); // IDs 0 são ignorados.
+    glDeleteVertexArrays(1, &VAO);
+}
+
 // ----------------------------------------------------------------------------
 // ESTRUTURA MESH (MALHA GEOMÉTRICA)
 // ----------------------------------------------------------------------------
@@ -277,28 +481,41 @@ struct Mesh {
     std::vector<Group>  groups;
     // ID do Vertex Array Object que encapsula o estado de renderização desta malha.
     GLuint              VAO = 0;
+    // Número de índices no EBO do VAO (0 = malha não indexada, desenhada com glDrawArrays).
+    GLsizei             indexCount = 0;
+    // Índices dos triângulos das malhas indexadas, guardados para o envio adiado (upload).
+    std::vector<unsigned int> indices;
+    // Malha lida de um pacote de cena: vértices já intercalados (e índices) apontando para o
+    // arquivo mapeado, enviados por upload() sem cópia. Não há vetores paralelos nem grupos.
+    std::shared_ptr<const Vertex>       packedVertices;
+    std::shared_ptr<const unsigned int> packedIndices;
+    size_t                              packedVertexCount = 0, packedIndexCount = 0;
 
     Mesh() = default;
 
     /**
-     * @brief Construtor que monta a malha a partir de dados brutos e separados.
-     * @details Este construtor é ideal para quando os dados são lidos de um formato
-     * como .obj, onde vértices, normais e UVs são listados separadamente.
-     * @param verts Vetor de posições de vértices.
-     * @param maps Vetor de coordenadas de textura.
-     * @param norms Vetor de normais.
-     * @param groups_ Vetor de grupos de faces.
+     * @brief Monta a malha sobre dados já intercalados de um pacote de cena (ver ScenePack::view).
+     * @details Só guarda os ponteiros; o VAO é criado por upload(), que então solta o pacote.
      */
-    Mesh(const std::vector<Vec3>& verts,
-        const std::vector<Vec2>& maps,
-        const std::vector<Vec3>& norms,
-        const std::vector<Group>& groups_)
-        : vertices(verts), mappings(maps), normals(norms), groups(groups_)
+    Mesh(std::shared_ptr<const Vertex> vertices_, size_t vertexCount_,
+        std::shared_ptr<const unsigned int> indices_, size_t indexCount_)
+        : packedVertices(std::move(vertices_)), packedIndices(std::move(indices_)),
+          packedVertexCount(vertexCount_), packedIndexCount(packedIndices ? indexCount_ : 0)
     {
-        // Para configurar o VAO, precisamos de um vetor único e intercalado.
-        // Este loop cria esse vetor 'interleaved' a partir dos vetores 'paralelos'.
-        std::vector<Vertex> interleaved;
-        interleaved.reserve(vertices.size()); // Pre-aloca memória para eficiência.
+    }
+
+    /**
+     * @brief Número de vértices da malha (para glDrawArrays), venha ela dos vetores ou de um pacote.
+     */
+    size_t vertexCount() const { return vertices.empty() ? packedVertexCount : vertices.size(); }
+
+    /**
+     * @brief Os vetores paralelos reunidos no formato intercalado enviado à GPU.
+     */
+    std::vector<Vertex> interleaved() const
+    {
+        std::vector<Vertex> out;
+        out.reserve(vertices.size()); // Pre-aloca memória para eficiência.
         for (size_t i = 0; i < vertices.size(); ++i) {
             Vertex v;
             v.x = vertices[i].x;
@@ -309,10 +526,59 @@ struct Mesh {
             v.nx = normals[i].x;
             v.ny = normals[i].y;
             v.nz = normals[i].z;
-            interleaved.push_back(v);
+            out.push_back(v);
         }
+        return out;
+    }
+
+    /**
+     * @brief Construtor que monta a malha a partir de dados brutos e separados.
+     * @details Este construtor é ideal para quando os dados são lidos de um formato
+     * como .obj, onde vértices, normais e UVs são listados separadamente.
+     * @param verts Vetor de posições de vértices.
+     * @param maps Vetor de coordenadas de textura.
+     * @param norms Vetor de normais.
+     * @param groups_ Vetor de grupos de faces.
+     * @param upload_ Se false, monta só a cópia em CPU; o VAO é criado depois, por upload().
+     */
+    Mesh(std::vector<Vec3> verts,
+        std::vector<Vec2> maps,
+        std::vector<Vec3> norms,
+        std::vector<Group> groups_,
+        bool upload_ = true)
+        : vertices(std::move(verts)), mappings(std::move(maps)), normals(std::move(norms)), groups(std::move(groups_))
+    {
+        if (upload_) upload();
+    }
+
+    /**
+     * @brief Cria o VAO (e o EBO, se a malha for indexada) a partir da cópia em CPU.
+     * @details Para malhas montadas sem contexto OpenGL (parâmetro `upload` = false); deve ser
+     * chamado na thread dona do contexto. Não faz nada se o VAO já existir.
+     */
+    void upload()
+    {
+        if (VAO) return;
+        if (packedVertices) {
+            // Direto do pacote mapeado para a GPU.
+            VAO = setupGeometry(packedVertices.get(), packedVertexCount);
+            if (packedIndexCount) attachIndexBuffer(VAO, packedIndices.get(), packedIndexCount);
+            indexCount = static_cast<GLsizei>(packedIndexCount);
+            packedVertices.reset();
+            packedIndices.reset();
+            return;
+        }
+        // Para configurar o VAO, precisamos de um vetor único e intercalado,
+        // criado a partir dos vetores 'paralelos'.
+        const std::vector<Vertex> interleaved = this->interleaved();
         // Com o vetor intercalado pronto, chama a função para criar o VAO/VBO.
-        VAO = setupGeometry(interleaved);
+        if (!indices.empty()) {
+            VAO = setupGeometry(interleaved, indices);
+            indexCount = static_cast<GLsizei>(indices.size());
+        }
+        else {
+            VAO = setupGeometry(interleaved);
+        }
     }
 
     /**
@@ -320,14 +586,18 @@ struct Mesh {
      * @details Usado para geometria gerada proceduralmente, como a pista de corrida,
      * onde é mais fácil gerar os dados já no formato 'Vertex'.
      * @param interleavedVerts Vetor de vértices já no formato intercalado para a GPU.
-     * @param indices Vetor de índices que definem os triângulos.
+     * @param indices_ Vetor de índices que definem os triângulos.
      * @param groupName Nome para o grupo padrão a ser criado.
      * @param mtlName Nome do material para o grupo padrão.
+     * @param upload_ Se false, monta só a cópia em CPU (sem VAO), o que dispensa um contexto
+     * OpenGL na thread atual; o VAO é criado depois, por upload().
      */
     Mesh(const std::vector<Vertex>& interleavedVerts,
-        const std::vector<unsigned int>& indices,
+        const std::vector<unsigned int>& indices_,
         const std::string& groupName = "",
-        const std::string& mtlName = "")
+        const std::string& mtlName = "",
+        bool upload_ = true)
+        : indices(indices_)
     {
         // 1) Embora os dados já estejam intercalados para a GPU, a estrutura Mesh também
         //    mantém vetores paralelos. Este bloco os preenche.
@@ -365,8 +635,18 @@ struct Mesh {
             currentGroup->addFace(face);
         }
 
-        // 5) Monta o VAO a partir do vetor intercalado recebido.
-        VAO = setupGeometry(interleavedVerts);
+        // 5) Monta o VAO a partir do vetor intercalado recebido. Se houver índices,
+        //    eles vão para um EBO e os vértices compartilhados são enviados uma única vez.
+        if (!upload_) {
+            return;
+        }
+        if (!indices.empty()) {
+            VAO = setupGeometry(interleavedVerts, indices);
+            indexCount = static_cast<GLsizei>(indices.size());
+        }
+        else {
+            VAO = setupGeometry(interleavedVerts);
+        }
     }
 };
 
@@ -390,8 +670,18 @@ struct Object3D {
     GLuint                 incrementalAngle; // Flag para rotação incremental (não usado neste projeto).
     Material               material;      // Propriedades de material.
     GLuint                 textureID = 0; // ID da textura OpenGL.
+    TextureImage           textureImage;  // Textura já decodificada, esperando upload() (só com upload_ = false).
     // Vetor de pontos que definem a trajetória de animação do objeto.
     std::vector<glm::vec3> animationPositions;
+    // Mesma trajetória, com tabela de comprimento de arco, para a animação com velocidade constante.
+    AnimationPath          animationPath;
+    AnimationCursor        animationCursor;       // Distância percorrida na trajetória.
+    float                  animationSpeed = 2.0f; // Velocidade (unidades por segundo).
+    // Gravações longas demais para carregar inteiras: reproduzidas em streaming (animationPositions fica vazio).
+    // Compartilhado porque Object3D é copiado para o mapa de objetos.
+    std::shared_ptr<AnimationStream> animationStream;
+    // Pista gerada no editor: desenhada pelos blocos com LOD de `trackChunks`, não pela malha única.
+    bool                   drawsTrackChunks = false;
 
     Object3D() = default;
 
@@ -407,11 +697,13 @@ struct Object3D {
         const glm::vec3& pos_ = glm::vec3(0.0f),
         const glm::vec3& rot_ = glm::vec3(0.0f),
         const glm::vec3& ang_ = glm::vec3(0.0f),
-        GLuint              incAng = 0)
+        GLuint              incAng = 0,
+        bool                upload_ = true)
         : name(_name), objFilePath(objPath), mtlFilePath(mtlPath), scale(scale_),
           position(pos_), rotation(rot_), angle(ang_), incrementalAngle(incAng)
     {
         // --- PARSING DO ARQUIVO .OBJ ---
+        PROFILE_ZONE("Object3D: leitura do .obj");
 
         std::ifstream file(objFilePath);
         if (!file.is_open()) {
@@ -419,12 +711,17 @@ struct Object3D {
             return;
         }
 
+        // Os dados temporários da leitura ficam na arena da thread, liberada de uma vez ao fim.
+        ScratchArena& scratch = ScratchArena::forThisThread();
+        ScratchArena::Scope scratchScope(scratch);
+
         // Buffers temporários para ler todos os vértices, UVs e normais do arquivo.
         // Eles são chamados de "raw" porque estão na ordem em que aparecem no arquivo.
         std::string line;
-        std::vector<glm::vec3> raw_positions;
-        std::vector<glm::vec2> raw_texcoords;
-        std::vector<glm::vec3> raw_normals;
+        std::pmr::vector<glm::vec3> raw_positions(scratch.resource());
+        std::pmr::vector<glm::vec2> raw_texcoords(scratch.resource());
+        std::pmr::vector<glm::vec3> raw_normals(scratch.resource());
+        std::pmr::vector<std::string_view> tokens(scratch.resource()); // Campos da linha "f" atual.
 
         // Vetores finais que serão usados para construir a Mesh. Estes vetores
         // terão seus dados alinhados, ou seja, a posição i, UV i e normal i
@@ -441,9 +738,8 @@ struct Object3D {
 
         // 2 Leitura do arquivo .obj linha por linha.
         while (std::getline(file, line)) {
-            std::istringstream ss(line);
-            std::string type;
-            ss >> type; // O primeiro token da linha define o tipo de dado.
+            LineScanner ss(line);
+            const std::string_view type = ss.token(); // O primeiro token da linha define o tipo de dado.
 
             if (type == "v") { // Posição do vértice
                 glm::vec3 pos;
@@ -470,43 +766,48 @@ struct Object3D {
             else if (type == "f") { // Definição de face
                 // A lógica aqui lida com polígonos de N vértices, triangulando-os
                 // usando uma abordagem de "triangle fan" a partir do primeiro vértice.
-                std::vector<std::string> tokens;
-                std::string tok;
-                while (ss >> tok) tokens.push_back(tok);
+                tokens.clear();
+                for (std::string_view tok = ss.token(); !tok.empty(); tok = ss.token())
+                    tokens.push_back(tok);
                 if (tokens.size() < 3) continue; // Pula se não for pelo menos um triângulo.
 
                 for (size_t i = 1; i + 1 < tokens.size(); ++i) {
                     Face face;
+                    face.verts.reserve(3);
+                    face.texts.reserve(3);
+                    face.norms.reserve(3);
                     // Monta um triângulo com o primeiro vértice, o vértice i, e o vértice i+1.
-                    std::array<std::string, 3> idxs = { tokens[0], tokens[i], tokens[i + 1] };
+                    std::array<std::string_view, 3> idxs = { tokens[0], tokens[i], tokens[i + 1] };
 
                     for (int k = 0; k < 3; ++k) {
-                        const std::string& vertStr = idxs[k]; // Ex: "1/2/3"
+                        const std::string_view vertStr = idxs[k]; // Ex: "1/2/3"
                         int vIdx = -1, tIdx = -1, nIdx = -1; // Índices de posição, textura e normal
                         
                         // --- Parsing do formato de face "v/t/n" ---
                         // O código a seguir é robusto para lidar com os diferentes formatos
                         // que uma face pode ter em um arquivo .obj (v, v/t, v//n, v/t/n).
+                        // Os índices do .obj começam em 1; um campo inválido fica como ausente (-1).
+                        auto index = [](std::string_view field) { int i = 0; parseNumber(field, i); return i - 1; };
                         size_t firstSlash = vertStr.find('/');
-                        size_t secondSlash = (firstSlash == std::string::npos
-                            ? std::string::npos
+                        size_t secondSlash = (firstSlash == std::string_view::npos
+                            ? std::string_view::npos
                             : vertStr.find('/', firstSlash + 1));
 
-                        if (firstSlash == std::string::npos) { // Formato: "v"
-                            vIdx = std::stoi(vertStr) - 1;
+                        if (firstSlash == std::string_view::npos) { // Formato: "v"
+                            vIdx = index(vertStr);
                         }
-                        else if (secondSlash == std::string::npos) { // Formato: "v/t"
-                            vIdx = std::stoi(vertStr.substr(0, firstSlash)) - 1;
-                            tIdx = std::stoi(vertStr.substr(firstSlash + 1)) - 1;
+                        else if (secondSlash == std::string_view::npos) { // Formato: "v/t"
+                            vIdx = index(vertStr.substr(0, firstSlash));
+                            tIdx = index(vertStr.substr(firstSlash + 1));
                         }
                         else if (secondSlash == firstSlash + 1) { // Formato: "v//n"
-                            vIdx = std::stoi(vertStr.substr(0, firstSlash)) - 1;
-                            nIdx = std::stoi(vertStr.substr(secondSlash + 1)) - 1;
+                            vIdx = index(vertStr.substr(0, firstSlash));
+                            nIdx = index(vertStr.substr(secondSlash + 1));
                         }
                         else { // Formato: "v/t/n"
-                            vIdx = std::stoi(vertStr.substr(0, firstSlash)) - 1;
-                            tIdx = std::stoi(vertStr.substr(firstSlash + 1, secondSlash - firstSlash - 1)) - 1;
-                            nIdx = std::stoi(vertStr.substr(secondSlash + 1)) - 1;
+                            vIdx = index(vertStr.substr(0, firstSlash));
+                            tIdx = index(vertStr.substr(firstSlash + 1, secondSlash - firstSlash - 1));
+                            nIdx = index(vertStr.substr(secondSlash + 1));
                         }
 
                         // Com os índices extraídos, busca os dados nos vetores "raw".
@@ -530,7 +831,7 @@ struct Object3D {
                     }
 
                     // Adiciona a face recém-criada ao grupo atual.
-                    currentGroup->addFace(face);
+                    currentGroup->addFace(std::move(face));
                 }
             }
         }
@@ -538,14 +839,49 @@ struct Object3D {
         file.close();
 
         // 3 Com os vetores alinhados e os grupos preenchidos, constrói o objeto Mesh.
-        //    Isso também irá gerar o VAO/VBO.
-        mesh = Mesh(positions, texcoords, normals, groups);
+        //    Isso também irá gerar o VAO/VBO (a menos que o envio seja adiado).
+        mesh = Mesh(std::move(positions), std::move(texcoords), std::move(normals), std::move(groups), upload_);
 
         // 4 Carrega o arquivo de material e a textura associada.
         material = setupMtl(mtlFilePath);
-        if (!material.textureName.empty()) {
-            textureID = setupTexture(material.textureName);
+        if (upload_) upload();
+        else if (!material.textureName.empty()) textureImage = decodeTexture(material.textureName);
+    }
+
+    /**
+     * @brief Constrói o objeto a partir de uma malha já em memória (por exemplo, a pista gerada
+     * no editor), sem ler nenhum .obj.
+     */
+    Object3D(const std::string& _name,
+        Mesh&& mesh_,
+        const std::string& mtlPath,
+        const glm::vec3& scale_ = glm::vec3(1.0f),
+        const glm::vec3& pos_ = glm::vec3(0.0f),
+        const glm::vec3& rot_ = glm::vec3(0.0f),
+        const glm::vec3& ang_ = glm::vec3(0.0f),
+        GLuint              incAng = 0,
+        bool                upload_ = true)
+        : name(_name), mtlFilePath(mtlPath), mesh(std::move(mesh_)), scale(scale_),
+          position(pos_), rotation(rot_), angle(ang_), incrementalAngle(incAng)
+    {
+        material = setupMtl(mtlFilePath);
+        if (upload_) upload();
+        else if (!material.textureName.empty()) textureImage = decodeTexture(material.textureName);
+    }
+
+    /**
+     * @brief Envia para a GPU o que ainda estiver só em CPU: a malha e a textura do material.
+     * @details Deve ser chamado na thread dona do contexto OpenGL. A textura é decodificada aqui
+     * só se ainda não tiver sido (`textureImage`).
+     */
+    void upload()
+    {
+        mesh.upload();
+        if (!textureID && !material.textureName.empty()) {
+            if (!textureImage.valid()) textureImage = decodeTexture(material.textureName);
+            textureID = uploadTexture(textureImage);
         }
+        textureImage = TextureImage(); // Os pixels já estão na GPU.
     }
 
     // Métodos para obter acesso à malha.
@@ -0,0 +1,234 @@
+#ifndef GPUPROFILER_HPP
+#define GPUPROFILER_HPP
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+// ----------------------------------------------------------------------------
+// TEMPO DE GPU POR PASSADA (CONSULTAS DE TIMESTAMP)
+// ----------------------------------------------------------------------------
+
+// Frames em andamento: as consultas de um frame só são lidas GPU_PROFILER_LATENCY frames depois,
+// quando a GPU já terminou de executá-lo. Assim a leitura não espera pela GPU.
+const int    GPU_PROFILER_LATENCY = 4;
+// Amostras (frames) por passada usadas nas médias e percentis.
+const size_t GPU_STATS_WINDOW = 240;
+
+/**
+ * @struct GpuPassStats
+ * @brief Estatísticas de uma passada sobre as últimas GPU_STATS_WINDOW amostras.
+ */
+struct GpuPassStats {
+    const char* name = "";
+    size_t      samples = 0;   // Amostras na janela.
+    double      averageMs = 0.0, p50Ms = 0.0, p95Ms = 0.0, p99Ms = 0.0, maxMs = 0.0;
+};
+
+/**
+ * @class GpuProfiler
+ * @brief Mede o tempo de GPU de cada passada de desenho (objetos, curvas, editor...).
+ * @details Cada passada é cercada por dois `glQueryCounter(GL_TIMESTAMP)` (ao contrário de
+ * GL_TIME_ELAPSED, timestamps permitem passadas aninhadas, como a pista dentro dos objetos).
+ * As consultas ficam em um conjunto por frame, reaproveitado a cada GPU_PROFILER_LATENCY
+ * frames: quando um conjunto volta a ser usado, seus resultados já estão prontos e são lidos
+ * sem parar a thread. Se a GPU estiver mais atrasada que isso, o frame é descartado (e contado
+ * em `droppedFrames`), em vez de esperar. Uma passada medida várias vezes no mesmo frame
+ * soma os tempos. Só na thread dona do contexto.
+ */
+class GpuProfiler {
+public:
+    /**
+     * @brief Apaga as consultas. Deve ser chamada com o contexto ainda ativo.
+     */
+    void release()
+    {
+        for (FrameQueries& frame : frames) {
+            if (!frame.queries.empty())
+                glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            frame = FrameQueries();
+        }
+    }
+
+    /**
+     * @brief Registra uma passada e retorna seu identificador. `name` precisa ser um literal.
+     */
+    int addPass(const char* name)
+    {
+        Pass pass;
+        pass.name = name;
+        passes.push_back(pass);
+        return static_cast<int>(passes.size()) - 1;
+    }
+
+    /**
+     * @brief Início de um frame: lê os resultados do frame que usou este conjunto de consultas.
+     */
+    void beginFrame()
+    {
+        FrameQueries& frame = frames[frameIndex % GPU_PROFILER_LATENCY];
+        if (frame.pending)
+            collect(frame);
+        frame.entries.clear();
+        frame.used = 0;
+        frame.pending = false;
+    }
+
+    void endFrame()
+    {
+        frames[frameIndex % GPU_PROFILER_LATENCY].pending = true;
+        ++frameIndex;
+    }
+
+    /**
+     * @brief Marca o início de uma passada (`pass` vem de addPass). Deve ser fechada com `end`.
+     */
+    void begin(int pass)
+    {
+        FrameQueries& frame = frames[frameIndex % GPU_PROFILER_LATENCY];
+        Entry entry;
+        entry.pass = pass;
+        entry.beginQuery = timestamp(frame);
+        frame.entries.push_back(entry);
+    }
+
+    void end(int pass)
+    {
+        FrameQueries& frame = frames[frameIndex % GPU_PROFILER_LATENCY];
+        // Fecha a entrada aberta mais recente da passada (passadas diferentes podem se aninhar).
+        for (auto it = frame.entries.rbegin(); it != frame.entries.rend(); ++it) {
+            if (it->pass == pass && it->endQuery < 0) {
+                it->endQuery = timestamp(frame);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @class Scope
+     * @brief Mede a passada do construtor ao destrutor. Com `profiler` nulo, não faz nada.
+     */
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler_, int pass_) : profiler(profiler_), pass(pass_) { if (profiler) profiler->begin(pass); }
+        ~Scope() { if (profiler) profiler->end(pass); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        GpuProfiler* profiler;
+        int          pass;
+    };
+
+    /**
+     * @brief Média, percentis (50, 95 e 99) e máximo de cada passada na janela atual.
+     */
+    std::vector<GpuPassStats> stats() const
+    {
+        std::vector<GpuPassStats> result;
+        std::vector<uint64_t> sorted;
+        for (const Pass& pass : passes) {
+            GpuPassStats s;
+            s.name = pass.name;
+            s.samples = pass.window.size();
+            if (!pass.window.empty()) {
+                sorted = pass.window;
+                std::sort(sorted.begin(), sorted.end());
+                uint64_t sum = 0;
+                for (uint64_t ns : sorted) sum += ns;
+                auto percentile = [&](double p) {
+                    const size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+                    return sorted[index] / 1e6;
+                };
+                s.averageMs = sum / 1e6 / sorted.size();
+                s.p50Ms = percentile(0.50);
+                s.p95Ms = percentile(0.95);
+                s.p99Ms = percentile(0.99);
+                s.maxMs = sorted.back() / 1e6;
+            }
+            result.push_back(s);
+        }
+        return result;
+    }
+
+    uint64_t measuredFrames() const { return measured; } // Frames lidos desde o início.
+    uint64_t droppedFrames() const { return dropped; }   // Frames descartados (GPU atrasada).
+
+private:
+    struct Pass {
+        const char*           name = "";
+        std::vector<uint64_t> window;      // Tempos (ns), em anel de GPU_STATS_WINDOW.
+        size_t                next = 0;
+        uint64_t              frameSum = 0; // Soma no frame sendo lido.
+        bool                  touched = false;
+    };
+
+    struct Entry {
+        int pass = 0;
+        int beginQuery = -1, endQuery = -1; // Índices em FrameQueries::queries.
+    };
+
+    struct FrameQueries {
+        std::vector<GLuint> queries;  // Conjunto do frame; cresce sob demanda e é reaproveitado.
+        size_t              used = 0;
+        std::vector<Entry>  entries;
+        bool                pending = false; // Consultas emitidas e ainda não lidas.
+    };
+
+    int timestamp(FrameQueries& frame)
+    {
+        if (frame.used == frame.queries.size()) {
+            const size_t grow = std::max<size_t>(8, frame.queries.size());
+            frame.queries.resize(frame.queries.size() + grow);
+            glGenQueries(static_cast<GLsizei>(grow), frame.queries.data() + frame.used);
+        }
+        glQueryCounter(frame.queries[frame.used], GL_TIMESTAMP);
+        return static_cast<int>(frame.used++);
+    }
+
+    void collect(FrameQueries& frame)
+    {
+        if (frame.used == 0)
+            return;
+        // As consultas terminam em ordem: se a última está pronta, todas estão.
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            ++dropped;
+            return;
+        }
+        for (const Entry& entry : frame.entries) {
+            if (entry.endQuery < 0)
+                continue;
+            GLuint64 start = 0, end = 0;
+            glGetQueryObjectui64v(frame.queries[entry.beginQuery], GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(frame.queries[entry.endQuery], GL_QUERY_RESULT, &end);
+            Pass& pass = passes[entry.pass];
+            pass.frameSum += (end > start) ? end - start : 0;
+            pass.touched = true;
+        }
+        for (Pass& pass : passes) {
+            if (!pass.touched)
+                continue;
+            if (pass.window.size() < GPU_STATS_WINDOW)
+                pass.window.push_back(pass.frameSum);
+            else
+                pass.window[pass.next] = pass.frameSum;
+            pass.next = (pass.next + 1) % GPU_STATS_WINDOW;
+            pass.frameSum = 0;
+            pass.touched = false;
+        }
+        ++measured;
+    }
+
+    std::vector<Pass> passes;
+    FrameQueries      frames[GPU_PROFILER_LATENCY];
+    uint64_t          frameIndex = 0;
+    uint64_t          measured = 0;
+    uint64_t          dropped = 0;
+};
+
+#endif // GPUPROFILER_HPP
@@ -0,0 +1,222 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// ARQUIVO MAPEADO EM MEMÓRIA (SOMENTE LEITURA)
+// ----------------------------------------------------------------------------
+
+/**
+ * @class MappedFile
+ * @brief Mapeia um arquivo inteiro no espaço de endereços do processo (mmap / MapViewOfFile).
+ * @details O conteúdo não é copiado para a memória: o sistema operacional carrega as páginas
+ * sob demanda quando são acessadas e pode descartá-las sob pressão de memória. Assim, ler
+ * um arquivo de vários gigabytes custa apenas os trechos realmente usados.
+ * Não é copiável; pode ser movido.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            data_ = other.data_;
+            size_ = other.size_;
+            view_ = other.view_;
+            viewSize_ = other.viewSize_;
+#ifdef _WIN32
+            file_ = other.file_;
+            mapping_ = other.mapping_;
+            other.file_ = INVALID_HANDLE_VALUE;
+            other.mapping_ = nullptr;
+#endif
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.view_ = nullptr;
+            other.viewSize_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Abre e mapeia o arquivo. Retorna false (sem mapear nada) em caso de erro ou arquivo vazio.
+     */
+    bool open(const std::string& path)
+    {
+        return open(path, 0, SIZE_MAX);
+    }
+
+    /**
+     * @brief Mapeia só o trecho [offset, offset + length) do arquivo (limitado ao fim do arquivo).
+     * @details O sistema exige que o mapeamento comece num limite de alocação, então a visão
+     * começa no limite anterior a `offset`; `data()` e `size()` já se referem só ao trecho.
+     * Permite ler uma seção de um pacote de cena (ScenePack) como se fosse um arquivo independente.
+     * Retorna false em caso de erro ou trecho vazio.
+     */
+    bool open(const std::string& path, size_t offset, size_t length)
+    {
+        close();
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) <= offset) { close(); return false; }
+        length = static_cast<size_t>(std::min<uint64_t>(length, static_cast<uint64_t>(fileSize.QuadPart) - offset));
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) { close(); return false; }
+        const uint64_t start = offset / granularity() * granularity();
+        void* view = MapViewOfFile(mapping_, FILE_MAP_READ, static_cast<DWORD>(start >> 32),
+            static_cast<DWORD>(start), static_cast<SIZE_T>(offset + length - start));
+        if (!view) { close(); return false; }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) <= offset) { ::close(fd); return false; }
+        length = static_cast<size_t>(std::min<uint64_t>(length, static_cast<uint64_t>(st.st_size) - offset));
+        const size_t start = offset / granularity() * granularity();
+        void* view = mmap(nullptr, offset + length - start, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(start));
+        ::close(fd); // O mapeamento continua válido após fechar o descritor.
+        if (view == MAP_FAILED) return false;
+#endif
+        view_ = static_cast<const uint8_t*>(view);
+        viewSize_ = static_cast<size_t>(offset + length - start);
+        data_ = view_ + (offset - start);
+        size_ = length;
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (view_) UnmapViewOfFile(view_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (view_) munmap(const_cast<uint8_t*>(view_), viewSize_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        view_ = nullptr;
+        viewSize_ = 0;
+    }
+
+    /**
+     * @brief Avisa o sistema que o trecho [offset, offset + length) será lido em breve.
+     * @details No Windows não há equivalente simples; quem lê o trecho numa thread de
+     * pré-carregamento já provoca as faltas de página fora da thread principal.
+     */
+    void willNeed(size_t offset, size_t length) const
+    {
+#ifndef _WIN32
+        uint8_t* begin = nullptr;
+        length = pageRange(offset, length, /*inward=*/false, begin);
+        if (length) madvise(begin, length, MADV_WILLNEED);
+#else
+        (void)offset; (void)length;
+#endif
+    }
+
+    /**
+     * @brief Permite ao sistema descartar as páginas do trecho (já consumido) da memória física.
+     * @details As páginas continuam mapeadas: se forem lidas de novo, voltam do disco.
+     */
+    void release(size_t offset, size_t length) const
+    {
+        uint8_t* begin = nullptr;
+        length = pageRange(offset, length, /*inward=*/true, begin);
+        if (!length) return;
+#ifdef _WIN32
+        // VirtualUnlock em páginas não travadas as remove do working set do processo.
+        VirtualUnlock(begin, length);
+#else
+        madvise(begin, length, MADV_DONTNEED);
+#endif
+    }
+
+    bool           isOpen() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t         size() const { return size_; }
+
+private:
+    // Alinha o trecho (limitado ao arquivo) às páginas e devolve o tamanho alinhado, com o início
+    // em `begin`: `inward` mantém só as páginas inteiramente contidas nele; caso contrário, inclui
+    // as páginas parcialmente cobertas (sem sair da visão mapeada).
+    size_t pageRange(size_t offset, size_t length, bool inward, uint8_t*& begin) const
+    {
+        if (!data_ || offset >= size_) return 0;
+        const uintptr_t page = pageSize();
+        const uintptr_t first = reinterpret_cast<uintptr_t>(data_) + offset;
+        const uintptr_t last = first + std::min(length, size_ - offset);
+        const uintptr_t viewEnd = (reinterpret_cast<uintptr_t>(view_) + viewSize_ + page - 1) / page * page;
+        const uintptr_t b = inward ? (first + page - 1) / page * page : first / page * page;
+        const uintptr_t e = inward ? last / page * page : std::min((last + page - 1) / page * page, viewEnd);
+        begin = reinterpret_cast<uint8_t*>(b);
+        return (e > b) ? static_cast<size_t>(e - b) : 0;
+    }
+
+    static size_t pageSize()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    // Alinhamento exigido para o início de um mapeamento (no Windows, maior que a página).
+    static size_t granularity()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        return pageSize();
+#endif
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t         size_ = 0;
+    const uint8_t* view_ = nullptr; // Início da visão mapeada (data_ pode estar adiante, ver open).
+    size_t         viewSize_ = 0;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_HPP
@@ -5,6 +5,17 @@
 // --- INCLUDES ---
 #include "GeometryObjects.hpp" // Estruturas para objetos 3D, parsing de .obj e setup de geometria.
 #include "Shader.h"           // Classe que abstrai a compilação e linkagem de shaders.
+#include "ArcLength.hpp"      // Tabela de comprimento de arco para consultas por distância nas curvas.
+#include "TrackChunks.hpp"    // Pista dividida em blocos com culling por frustum e LOD por distância.
+#include "CarFleet.hpp"       // Atualização em lote (SoA + SIMD) das matrizes de muitos carros.
+#include "AnimationFile.hpp"  // Formato binário (.anim) de animação, quantizado e lido via mmap.
+#include "SpscQueue.hpp"      // Fila lock-free entre a thread principal e a de renderização.
+#include "FileWatcher.hpp"    // Detecção de arquivos da cena modificados (hot reload).
+#include "ScenePack.hpp"      // Pacote de cena: a cena e seus recursos em um arquivo, lido via mmap.
+#include "GpuProfiler.hpp"    // Tempo de GPU por passada de desenho (consultas de timestamp).
+#include "../../Common/include/JobSystem.hpp" // Tarefas com roubo de trabalho, compartilhadas pelos módulos.
+#include "../../Common/include/Profiler.hpp"  // Zonas de tempo de CPU, exportadas como Chrome Trace.
+#include "../../Common/include/Benchmark.hpp" // Suíte de benchmarks (mediana/p95, JSON, baseline).
 
 // Bibliotecas padrão do C++
 #include <iostream>
@@ -12,12 +23,37 @@
 #include <cassert>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <new>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <psapi.h>        // GetProcessMemoryInfo (windows.h já vem de MappedFile.hpp).
+#else
+#include <sys/resource.h> // getrusage
+#endif
 
 // Bibliotecas de Gráficos
 #include <glad/glad.h>   // Carregador de funções do OpenGL. Deve ser incluído antes de GLFW.
 #include <GLFW/glfw3.h>  // Biblioteca para criação de janelas, contextos OpenGL e gerenciamento de input.
+#ifdef GRAUB_EGL
+// Contexto sem janela e sem servidor gráfico para o modo headless (Linux: compile com
+// -DGRAUB_EGL e ligue com -lEGL). Sem ele, o modo headless usa uma janela GLFW oculta.
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 
 // ============================================================================
@@ -60,8 +96,117 @@ struct BSplineCurve {
     glm::vec4 color;                      // Cor para renderizar a curva.
     GLuint VAO;                           // VAO para desenhar a linha da curva.
     GLuint controlPointsVAO;              // VAO para desenhar os pontos de controle.
+    ArcLengthTable arcLength;             // Reparametrização por distância (positionAtDistance/tangentAtDistance).
 };
 
+/**
+ * @struct TrackPreview
+ * @brief Resultado intermediário da geração da pista, exibido no editor enquanto ela termina.
+ */
+struct TrackPreview {
+    std::vector<glm::vec3>    centerLine; // Linha central, no plano XY do editor.
+    std::vector<Vertex>       vertices;   // Malha (grossa ou completa) no plano do editor; vazia só com a linha central.
+    std::vector<unsigned int> indices;
+};
+
+/**
+ * @struct GeneratedScene
+ * @brief A cena gerada no editor, montada só em CPU e pronta para o envio à GPU.
+ */
+struct GeneratedScene {
+    Object3D     track, car;
+    BSplineCurve curve;
+    ChunkedTrack chunks;
+    std::vector<glm::vec3> animationPoints; // Dados de origem, para a gravação opcional em disco.
+    std::vector<glm::vec3> controlPoints;
+};
+
+/**
+ * @struct SceneObjectDesc
+ * @brief Um bloco "Type ... End" do arquivo de cena, como lido (sem carregar nenhum recurso).
+ */
+struct SceneObjectDesc {
+    std::string type, name;                       // "Mesh" ou "BSplineCurve".
+    std::string objFile, mtlFile, animFile;
+    float       animationSpeed = 2.0f;
+    glm::vec3   scale{ 1.0f }, position{ 0.0f }, rotation{ 0.0f }, angle{ 0.0f };
+    GLuint      incrementalAngle = 0;
+    std::vector<glm::vec3> controlPoints;         // Só em BSplineCurve.
+    GLuint      pointsPerSegment = 0;
+    glm::vec4   color{ 1.0f };
+};
+
+/**
+ * @struct SceneDesc
+ * @brief O conteúdo de um arquivo de cena: a configuração global e os objetos, na ordem do arquivo.
+ * @details É o que a recarga compara com a cena em uso para decidir o que reler.
+ */
+struct SceneDesc {
+    GlobalConfig                 config;
+    std::vector<SceneObjectDesc> objects;
+};
+
+// ============================================================================
+// CONTAGEM DE ALOCAÇÕES
+// ============================================================================
+// O operador new global é substituído só para contar as alocações no heap, de modo que a
+// carga da cena possa informar quantas fez. As demais formas de new/delete (arrays, nothrow,
+// com tamanho) usam estas por padrão.
+
+std::atomic<uint64_t> heapAllocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * @brief Maior uso de memória física (RSS) do processo até agora, em bytes.
+ */
+static size_t peakResidentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return static_cast<size_t>(usage.ru_maxrss) * 1024; // Em KB no Linux.
+    return 0;
+#endif
+}
+
+/**
+ * @brief Lê um inteiro da linha de comando, que deve estar em [minValue, maxValue].
+ * @return false se `text` não for inteiro ou estiver fora do intervalo (sem lançar exceção,
+ * ao contrário de std::stoi).
+ */
+static bool parseIntegerArgument(const char* text, long long minValue, long long maxValue, long long& value)
+{
+    errno = 0;
+    char* end = nullptr;
+    const long long parsed = std::strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < minValue || parsed > maxValue)
+        return false;
+    value = parsed;
+    return true;
+}
+
 // ============================================================================
 // PROTÓTIPOS DE FUNÇÕES
 // ============================================================================
@@ -77,15 +222,161 @@ void readSceneFile(const std::string&,
     std::vector<std::string>*,
     std::unordered_map<std::string, BSplineCurve>*,
     GlobalConfig*);
+bool parseSceneFile(const std::string& sceneFilePath, SceneDesc& scene);
+Object3D loadSceneObject(const SceneObjectDesc& desc, bool upload);
+std::vector<Object3D> loadSceneObjects(const std::vector<SceneObjectDesc>& descs);
+void loadSceneIntoViewer(const std::string& path);
+void pollSceneReload();
+void writeProfile();
+int runHeadless(const std::string& scenePath, int frames, const std::string& cameraPathFile);
+int runPipelineBenchmark(int argc, char** argv);
+GlobalConfig defaultGlobalConfig();
+int compileScenePack(const std::string& scenePath, const std::string& packPath);
+bool loadScenePack(const std::string& path, SceneDesc& scene, std::vector<Object3D>& objects);
 std::vector<glm::vec3> generateBSplinePoints(const std::vector<glm::vec3>& controlPoints, int pointsPerSegment);
 GLuint generateControlPointsBuffer(std::vector<glm::vec3> controlPoints);
 BSplineCurve createBSplineCurve(std::vector<glm::vec3> controlPoints, int pointsPerSegment);
-void generateTrackMesh(const std::vector<glm::vec3> centerPoints, float trackWidth,
+BSplineCurve buildBSplineCurve(const std::vector<glm::vec3>& controlPoints, int pointsPerSegment);
+void uploadBSplineCurve(BSplineCurve& bc);
+GLuint uploadLineStrip(const std::vector<glm::vec3>& points);
+void generateTrackMesh(const std::vector<glm::vec3>& centerPoints, float trackWidth,
     std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+void generateTrackMeshParallel(const std::vector<glm::vec3>& centerPoints, float trackWidth,
+    std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned int threadCount = 0,
+    const std::atomic<bool>* cancel = nullptr);
+void swapTrackYZ(std::vector<Vertex>& vertices);
+void buildTrackChunks(const std::vector<glm::vec3>& centerPoints, float trackWidth, float chunkLength,
+    ChunkedTrack& track, const std::atomic<bool>* cancel = nullptr);
 void exportAnimationPoints(const std::vector<glm::vec3>& points, const std::string& filename);
+void simulationStep(float dt);
+void resetSimulation();
 void generateSceneFile(const std::string& trackObj, const std::string& carObj,
     const std::string& animFile, const std::string& sceneFile,
     const std::vector<glm::vec3>& controlPoints);
+void applyGeneratedSceneConfig(GlobalConfig& config);
+GeneratedScene prepareGeneratedScene(Mesh&& trackMesh, const std::vector<glm::vec3>& animationPoints,
+    const std::vector<glm::vec3>& controlPoints, const std::vector<glm::vec3>& curvePoints,
+    float trackWidth, float chunkLength, const std::atomic<bool>* cancel = nullptr);
+void installGeneratedScene(GeneratedScene& scene);
+void pollTrackBuild(GLFWwindow* window);
+void cancelTrackBuild(GLFWwindow* window);
+void saveGeneratedSceneAsync(const Mesh& trackMesh, const std::vector<glm::vec3>& animationPoints,
+    const std::vector<glm::vec3>& controlPoints);
+
+// ============================================================================
+// GERAÇÃO DA PISTA EM SEGUNDO PLANO
+// ============================================================================
+
+// Etapas da geração da pista, na ordem em que são concluídas.
+enum TrackBuildStage {
+    TRACK_STAGE_CENTERLINE,  // Curva B-Spline central.
+    TRACK_STAGE_COARSE_MESH, // Malha com 1 a cada TRACK_PREVIEW_STRIDE amostras (só prévia).
+    TRACK_STAGE_FULL_MESH,   // Malha completa.
+    TRACK_STAGE_SCENE,       // Blocos, animação, curva e objetos da cena (só CPU).
+    TRACK_STAGE_COUNT
+};
+const char* const TRACK_STAGE_NAMES[TRACK_STAGE_COUNT] = { "linha central", "malha grossa", "malha completa", "cena" };
+const size_t TRACK_PREVIEW_STRIDE = 8;
+
+/**
+ * @class TrackBuildJob
+ * @brief Gera a pista e a cena do visualizador numa thread própria, sem bloquear os eventos.
+ * @details Cada etapa concluída publica uma prévia (linha central, malha grossa, malha
+ * completa), que a thread principal repassa à de renderização; o resultado final é uma
+ * GeneratedScene só em CPU. O pedido de cancelamento é visto entre etapas e dentro das
+ * etapas paralelas (a cada fatia do parallelFor). O tempo de cada etapa é impresso no console.
+ * Os métodos públicos são usados só pela thread principal.
+ */
+class TrackBuildJob {
+public:
+    ~TrackBuildJob() { stop(); }
+
+    /**
+     * @brief Cancela a geração em andamento (se houver) e inicia outra a partir de `controlPoints`
+     * (pontos de controle do editor, com a altura em Z).
+     */
+    void start(const std::vector<glm::vec3>& controlPoints, float trackWidth, float chunkLength)
+    {
+        stop(); // A geração anterior ainda escreve nos campos abaixo até a sua thread terminar.
+        cancelRequested = false;
+        completedStages = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            hasPreview = false;
+            hasResult = false;
+        }
+        active = true;
+        worker = std::thread(&TrackBuildJob::run, this, controlPoints, trackWidth, chunkLength);
+    }
+
+    /**
+     * @brief Pede a interrupção da geração e descarta o que ela produzir, sem esperar a thread:
+     * pode ser chamado de callbacks de entrada. A thread é juntada no próximo start ou em stop.
+     */
+    void cancel()
+    {
+        cancelRequested = true;
+        if (worker.joinable()) retired = std::move(worker);
+        active = false;
+    }
+
+    /**
+     * @brief Cancela a geração e espera a sua thread terminar (encerramento do programa).
+     */
+    void stop()
+    {
+        cancel();
+        if (retired.joinable()) retired.join();
+    }
+
+    bool running() const { return active; }                 // Iniciada e com o resultado ainda não retirado.
+    int  stagesDone() const { return completedStages.load(); }
+
+    /**
+     * @brief Retira a prévia mais recente, se houver uma nova desde a última chamada.
+     */
+    bool takePreview(TrackPreview& out)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!hasPreview) return false;
+        out = std::move(preview);
+        hasPreview = false;
+        return true;
+    }
+
+    /**
+     * @brief Retira o resultado final, se pronto; a geração deixa de estar ativa.
+     */
+    bool takeResult(GeneratedScene& out)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!hasResult) return false;
+            out = std::move(result);
+            hasResult = false;
+        }
+        worker.join(); // Publicar o resultado é a última coisa que a thread faz.
+        active = false;
+        return true;
+    }
+
+private:
+    void run(std::vector<glm::vec3> controlPoints, float trackWidth, float chunkLength);
+    bool finishStage(TrackBuildStage stage, std::chrono::steady_clock::time_point& stageStart);
+    void publishPreview(const TrackPreview& step);
+
+    std::thread       worker;
+    std::thread       retired;    // Thread de uma geração cancelada, ainda não juntada.
+    std::atomic<bool> cancelRequested{ false };
+    std::atomic<int>  completedStages{ 0 };
+    bool              active = false;
+
+    std::mutex        mutex;      // Protege os campos abaixo.
+    TrackPreview      preview;
+    bool              hasPreview = false;
+    GeneratedScene    result;
+    bool              hasResult = false;
+};
 
 // ============================================================================
 // VARIÁVEIS GLOBAIS
@@ -107,8 +398,15 @@ bool      moveW = false, moveA = false, moveS = false, moveD = false; // Flags d
 bool      editorMode = true;                     // Requisito 2a: A aplicação começa em modo editor.
 std::vector<glm::vec3> editorControlPoints;      // Requisito 2a: Armazena os pontos de controle clicados pelo usuário no editor.
 int       animationIndex = 0;                    // Índice atual na lista de pontos de animação do carro.
+bool      constantSpeedAnimation = true;         // Anima por distância (velocidade constante, interpolada); tecla M alterna.
+// A base original do carro (direita = frente x cima) tem determinante -1, ou seja, espelhava o
+// modelo em X. Os referenciais pré-calculados são rotações próprias; este espelhamento mantém
+// a aparência do carro igual à anterior.
+const glm::mat4 carBasisMirror = glm::scale(glm::mat4(1.0f), glm::vec3(-1.0f, 1.0f, 1.0f));
 float     trackWidth = 1.0f;                     // Largura da pista a ser gerada proceduralmente.
 GLuint    showCurves = 1;                        // Flag para exibir ou não as curvas de debug no modo visualizador.
+float     trackChunkLength = 10.0f;              // Comprimento (ao longo da pista) de cada bloco da malha da pista.
+ChunkedTrack trackChunks;                        // Blocos da pista com LODs, desenhados no lugar da malha única.
 
 // --- Controle de Altura da Pista no Editor ---
 // per-point “yellow level” (0→no yellow, 1→full yellow) & step size
@@ -135,13 +433,163 @@ std::unordered_map<std::string, BSplineCurve> bSplineCurves;
 
 // --- Controle de Tempo da Animação ---
 double lastFrameTime = 0.0;
-float  animAccumulator = 0.0f;              // Acumula o tempo delta para desacoplar a animação do framerate.
+float  animAccumulator = 0.0f;              // Acumula o tempo simulado para o modo de animação por amostras.
 const float STEP_TIME = 1.0f / 30.0f;       // Garante que a animação rode a 30 "passos" por segundo, independente da taxa de quadros.
 
+// --- Simulação com Passo Fixo ---
+// Câmera e animações avançam em passos fixos de SIMULATION_STEP, acumulando o tempo real de cada
+// frame (mesma ideia do `animAccumulator`). A renderização interpola entre os dois últimos estados
+// simulados, então o movimento é suave e independente da taxa de quadros.
+const float SIMULATION_STEP = 1.0f / 60.0f;
+const float MAX_FRAME_TIME = 0.25f;         // Limita o tempo de um frame lento, para a simulação não entrar em espiral.
+float  simAccumulator = 0.0f;               // Tempo real ainda não simulado.
+
+/**
+ * @struct AnimatedPose
+ * @brief Posição e orientação de um objeto animado em um passo da simulação.
+ */
+struct AnimatedPose {
+    glm::vec3 position;
+    glm::quat orientation;
+};
+
+/**
+ * @struct SimulationState
+ * @brief O que a renderização interpola entre dois passos da simulação.
+ */
+struct SimulationState {
+    glm::vec3 cameraPos{ 0.0f };
+    std::unordered_map<std::string, AnimatedPose> poses; // Por nome do objeto animado.
+};
+SimulationState simStates[2];               // Duplo buffer: simStates[currentSim] é o mais recente.
+int             currentSim = 0;
+
+// --- Cena Gerada no Editor ---
+// A cena gerada passa do editor ao visualizador em memória; gravá-la em disco (track.obj,
+// animation.anim, Scene.txt) é opcional e acontece em segundo plano.
+bool              saveGeneratedScene = true;  // `--no-save` desliga a gravação.
+std::future<void> pendingSave;                // Gravação em andamento (esperada antes de sair).
+TrackBuildJob     trackBuild;                 // Geração da pista disparada pela tecla espaço.
+const char* const WINDOW_TITLE = "Modelador de Pistas e Visualizador 3D";
+
+// --- Recarga da Cena (Hot Reload) ---
+// No visualizador, o arquivo de cena em uso e os arquivos que ele referencia são observados;
+// ao mudarem, só o que mudou é recarregado.
+FileWatcher              sceneWatcher;
+std::vector<std::string> watchedFiles;     // Arquivos observados por sceneWatcher (ordenados).
+std::string              liveScenePath;    // Arquivo de cena em uso (vazio = nenhum).
+SceneDesc                liveScene;        // Seu conteúdo, como aplicado por último.
+// Liberações de recursos OpenGL substituídos na recarga, enviadas com o próximo FramePacket.
+std::vector<std::function<void()>> pendingReleases;
+
+/**
+ * @struct TrackPreviewBuffers
+ * @brief Buffers da prévia da pista em geração, desenhada no modo editor.
+ * @details Pertencem à thread de renderização, que os troca inteiros entre dois frames.
+ */
+struct TrackPreviewBuffers {
+    GLuint  centerLineVAO = 0;
+    GLsizei centerLineCount = 0;
+    GLuint  meshVAO = 0;
+    GLsizei meshIndexCount = 0;
+};
+TrackPreviewBuffers trackPreviewBuffers;
+
+// --- Modo de Benchmark (`--uncapped`) ---
+bool   uncappedBenchmark = false;           // Desliga o vsync e imprime, a cada segundo, a taxa da simulação e os FPS.
+
+// --- Cache de Shaders ---
+// Programas já linkados são guardados em disco e reaproveitados nas próximas execuções.
+const char* SHADER_CACHE_DIRECTORY = "shader_cache";
+bool        useShaderCache = true;         // `--no-shader-cache` desliga (sempre compila).
+
+// --- Perfil de CPU ---
+// Com o perfilador ligado (`--profile` ou F9), as zonas `PROFILE_ZONE` são gravadas e exportadas
+// para `profilePath` ao apertar F9 de novo e ao sair.
+std::string profilePath = "profile.json";
+
+// --- Tempo de GPU (`--gpu-stats [arquivo.csv]`) ---
+// Média e percentis do tempo de GPU de cada passada, impressos a cada GPU_REPORT_INTERVAL
+// segundos e, com um arquivo, acrescentados a ele em CSV (para comparar versões).
+const double GPU_REPORT_INTERVAL = 1.0;
+bool        gpuStats = false;
+std::string gpuStatsCsvPath;
+
+// --- Modo Headless (`--headless <cena> [frames]`) ---
+// Sem janela visível nem input: carrega a cena, desenha um número fixo de frames num FBO ao
+// longo de um percurso de câmera e imprime as estatísticas do tempo de frame.
+const int  HEADLESS_DEFAULT_FRAMES = 600;
+const int  HEADLESS_WARMUP_FRAMES = 10;     // Frames iniciais fora das estatísticas (shaders, caches).
+bool       headlessMode = false;
+std::atomic<int>    headlessFramesDrawn{ 0 };
+std::vector<double> headlessFrameTimes;     // ms por frame; escrito pela thread de renderização, lido após o join.
+
+// --- Thread de Renderização ---
+// A thread de renderização é a única dona do contexto OpenGL. A thread principal trata os
+// eventos, roda a simulação e, a cada iteração, envia um retrato do que desenhar (FramePacket).
+// Trabalho OpenGL pedido pela thread principal (criar VAOs, carregar texturas) viaja nos
+// mesmos pacotes, como comandos executados antes do desenho.
+using RenderCommand = std::function<void()>;
+
+/**
+ * @struct DrawItem
+ * @brief Um objeto da cena pronto para ser desenhado: recursos OpenGL e matriz de modelo já calculada.
+ */
+struct DrawItem {
+    GLuint    VAO = 0;
+    GLsizei   indexCount = 0;   // > 0: desenha com glDrawElements.
+    GLsizei   vertexCount = 0;
+    GLuint    textureID = 0;
+    Material  material;
+    glm::mat4 model{ 1.0f };
+    unsigned  shaderFeatures = 0;   // Variante do shader de objetos (bits de `ShaderFeature`).
+    bool      chunkedTrack = false; // A pista gerada, desenhada pelos blocos de `trackChunks`.
+};
+
+/**
+ * @struct CurveItem
+ * @brief Uma curva B-Spline de debug e seus pontos de controle.
+ */
+struct CurveItem {
+    GLuint    VAO = 0, controlPointsVAO = 0;
+    GLsizei   curveCount = 0, controlCount = 0;
+    glm::vec4 color{ 1.0f };
+};
+
+/**
+ * @struct FramePacket
+ * @brief Tudo o que a thread de renderização precisa para um frame, copiado na thread principal.
+ * @details Pacotes só com `commands` (hasFrame = false) não substituem o frame em exibição.
+ */
+struct FramePacket {
+    std::vector<RenderCommand> commands;   // Executados na ordem, antes de desenhar.
+    bool         hasFrame = false;
+    bool         editorMode = true;
+    glm::mat4    view{ 1.0f }, projection{ 1.0f };
+    glm::vec3    cameraPos{ 0.0f };
+    GlobalConfig config;
+    std::vector<glm::vec3> editorPoints;   // Modo editor: pontos de controle e suas alturas.
+    std::vector<float>     editorLevels;
+    std::vector<DrawItem>  items;          // Modo visualizador.
+    std::vector<CurveItem> curves;
+    bool         showCurves = false;
+};
+
+SpscQueue<FramePacket, 4> frameQueue;       // Thread principal -> thread de renderização.
+std::atomic<bool> renderRunning{ true };
+std::atomic<bool> renderFailed{ false };
+std::atomic<bool> renderExited{ false };    // A thread de renderização terminou: ninguém mais consome a fila.
+std::atomic<int>  renderedFrames{ 0 };      // Frames apresentados desde a última leitura das estatísticas.
+
 // ============================================================================
 // SHADERS (modelo de iluminação completo: ambiente + difusa + especular + atenuação + fog)
 // ============================================================================
 
+// Os dois fontes abaixo são compilados em variantes (ver `ShaderVariants`): FOG, SPECULAR e
+// TEXTURED são `#define`s, e cada material usa a menor combinação que precisa
+// (`objectShaderFeatures`). Um objeto sem textura ou sem brilho não paga pela amostragem
+// nem pelo termo especular.
+
 /**
  * @brief Vertex Shader para os objetos 3D.
  * @details Responsável por transformar as posições dos vértices do espaço do modelo para o
@@ -156,7 +604,9 @@ layout (location = 1) in vec2 aTexCoord; // Coordenada de textura (UV).
 layout (location = 3) in vec3 aNormal;   // Vetor normal do vértice.
 
 // Saídas (out), que serão interpoladas e se tornarão entradas (in) no Fragment Shader.
+#ifdef TEXTURED
 out vec2 TexCoord;
+#endif
 out vec3 Normal;
 out vec3 FragPos;
 
@@ -174,8 +624,10 @@ void main() {
     // transposta da inversa da matriz de modelo corrige deformações na normal
     // causadas por escalas não uniformes no modelo.
     Normal      = mat3(transpose(inverse(model))) * aNormal;
+#ifdef TEXTURED
     // Passa a coordenada de textura diretamente para o Fragment Shader.
     TexCoord    = aTexCoord;
+#endif
 }
 )glsl";
 
@@ -190,7 +642,9 @@ const char* fragmentShaderSource = R"glsl(
 out vec4 FragColor; // A cor final que será escrita no framebuffer.
 
 // Entradas (in) recebidas (e interpoladas) do Vertex Shader.
+#ifdef TEXTURED
 in vec2 TexCoord;
+#endif
 in vec3 Normal;
 in vec3 FragPos;
 
@@ -201,16 +655,22 @@ uniform vec3 cameraPos;
 // Coeficientes do material (Ka, Kd, Ks, Ns) que definem como a superfície reage à luz.
 uniform float kaR, kaG, kaB; // Ambiente
 uniform float kdR, kdG, kdB; // Difusa
+#ifdef SPECULAR
 uniform float ksR, ksG, ksB; // Especular
 uniform float ns;            // Expoente especular (shininess)
+#endif
 
 // --- Uniforms de Fog e Atenuação ---
+#ifdef FOG
 uniform vec3 fogColor;
 uniform float fogStart, fogEnd;
+#endif
 uniform float attConstant, attLinear, attQuadratic;
 
 // --- Uniform de Textura ---
+#ifdef TEXTURED
 uniform sampler2D tex; // A textura do objeto (unidade de textura 0).
+#endif
 
 void main() {
     // --- CÁLCULO DE ILUMINAÇÃO (MODELO DE PHONG) ---
@@ -226,10 +686,15 @@ void main() {
     vec3 diffuse  = vec3(kdR, kdG, kdB) * diff * lightColor;
 
     // 3. Componente Especular: Simula o brilho/reflexo, depende da posição da câmera.
+    //    Sem SPECULAR (material com Ks nulo), o termo é zero e não é calculado.
+#ifdef SPECULAR
     vec3 viewDir    = normalize(cameraPos - FragPos);
     vec3 reflectDir = reflect(-lightDir, norm); // Calcula o vetor de reflexão da luz.
     float spec      = pow(max(dot(viewDir, reflectDir), 0.0), ns); // `ns` controla o tamanho e a intensidade do brilho.
     vec3 specular   = vec3(ksR, ksG, ksB) * spec * lightColor;
+#else
+    vec3 specular   = vec3(0.0);
+#endif
 
     // --- CÁLCULO DE ATENUAÇÃO ---
     // Simula a perda de intensidade da luz com a distância, usando uma equação quadrática.
@@ -240,15 +705,24 @@ void main() {
     vec3 lighting = (ambient + diffuse + specular) * attenuation;
 
     // Obtém a cor da textura na coordenada correspondente (amostragem).
+    // Sem TEXTURED, a superfície tem só a cor do material.
+#ifdef TEXTURED
     vec4 texColor = texture(tex, TexCoord);
+#else
+    vec4 texColor = vec4(1.0);
+#endif
 
     // --- CÁLCULO DE FOG (NEVOEIRO) ---
     // Interpola a cor do objeto iluminado com a cor do fog com base na distância da câmera.
+#ifdef FOG
     float distToCamera = length(cameraPos - FragPos);
     // `clamp` garante que o fator de mistura do fog fique entre 0.0 e 1.0.
     float fogFactor    = clamp((distToCamera - fogStart) / (fogEnd - fogStart), 0.0, 1.0);
     // `mix()` faz a interpolação linear: mix(cor_final, cor_inicial, fator).
     vec3 finalColor    = mix(lighting * texColor.rgb, fogColor, fogFactor);
+#else
+    vec3 finalColor    = lighting * texColor.rgb;
+#endif
 
     // Define a cor final do fragmento, combinando a cor calculada com a transparência da textura.
     FragColor = vec4(finalColor, texColor.a);
@@ -256,261 +730,619 @@ void main() {
 )glsl";
 
 // ============================================================================
-// FUNÇÃO PRINCIPAL
+// THREAD DE RENDERIZAÇÃO
 // ============================================================================
 
-int main() {
-    // --- INICIALIZAÇÃO DO AMBIENTE GRÁFICO ---
-    glfwInit();
-    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Modelador de Pistas e Visualizador 3D", nullptr, nullptr);
-    assert(window && "Falha ao criar janela GLFW");
-    glfwMakeContextCurrent(window);
+/**
+ * @brief Enfileira comandos OpenGL para a thread de renderização, sem esperar por eles.
+ * @details Se a fila estiver cheia, espera a thread de renderização consumir um pacote.
+ * @return false (sem enfileirar) se a thread de renderização já terminou.
+ */
+static bool postRenderCommand(RenderCommand command)
+{
+    FramePacket packet;
+    packet.commands.push_back(std::move(command));
+    while (!frameQueue.tryPush(packet)) {
+        if (renderExited) {
+            std::cerr << "Thread de renderizacao encerrada; comando descartado\n";
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
 
-    // Define as funções de callback que o GLFW chamará para tratar inputs.
-    glfwSetKeyCallback(window, key_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetMouseButtonCallback(window, mouse_button_callback);
-    // Requisito 2a: Cursor visível e normal no modo editor.
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+/**
+ * @brief Executa `command` na thread de renderização (dona do contexto OpenGL) e espera o fim.
+ * @details Usado para criar recursos OpenGL a partir da thread principal. Enquanto espera,
+ * a thread principal não mexe nos dados da cena, então o comando pode preenchê-los.
+ * @return false se a thread de renderização terminou sem executar o comando.
+ */
+static bool runOnRenderThread(const RenderCommand& command)
+{
+    std::promise<void> done;
+    std::future<void> finished = done.get_future();
+    if (!postRenderCommand([&command, &done] {
+            command();
+            done.set_value();
+        }))
+        return false;
+    while (finished.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready) {
+        // O comando pode ter sido executado na drenagem final da fila: confere o futuro uma última vez.
+        if (renderExited && finished.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            std::cerr << "Thread de renderizacao encerrada antes de executar o comando\n";
+            return false;
+        }
+    }
+    return true;
+}
 
-    // Inicializa o GLAD para carregar as funções do OpenGL. Essencial para usar OpenGL moderno.
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Falha ao inicializar GLAD\n";
-        return -1;
+/**
+ * @brief Maior distância entre a câmera e um ponto visível: o canto do plano distante do frustum.
+ */
+static float farthestVisibleDistance(const GlobalConfig& config)
+{
+    const float tanHalfFov = std::tan(glm::radians(config.fov) * 0.5f);
+    const float aspect = static_cast<float>(WIDTH) / HEIGHT;
+    return config.farPlane * std::sqrt(1.0f + tanHalfFov * tanHalfFov * (1.0f + aspect * aspect));
+}
+
+/**
+ * @brief Menor variante do shader de objetos que desenha o material sem mudar o resultado.
+ * @details O especular só entra se Ks não for nulo e a textura só se houver uma carregada. O
+ * nevoeiro só fica de fora quando não alcança nenhum fragmento visível (FogStart além do canto
+ * do plano distante, com FogEnd > FogStart); com FogEnd <= FogStart ele continua ligado e o
+ * shader dá o mesmo resultado de sempre.
+ */
+static unsigned objectShaderFeatures(const Material& material, GLuint textureID, const GlobalConfig& config)
+{
+    unsigned features = 0;
+    if (config.fogEnd <= config.fogStart || config.fogStart < farthestVisibleDistance(config))
+        features |= SHADER_FOG;
+    if (material.ksR != 0.0f || material.ksG != 0.0f || material.ksB != 0.0f)
+        features |= SHADER_SPECULAR;
+    if (textureID != 0)
+        features |= SHADER_TEXTURED;
+    return features;
+}
+
+/**
+ * @brief Monta o retrato do frame atual (thread principal) a partir da cena e da simulação.
+ * @param simAlpha Fração do passo de simulação decorrida, para interpolar câmera e poses.
+ */
+static void buildFramePacket(FramePacket& packet, float simAlpha)
+{
+    // Fração do passo atual já decorrida: peso da interpolação entre o estado anterior e o atual.
+    const SimulationState& previousState = simStates[1 - currentSim];
+    const SimulationState& currentState = simStates[currentSim];
+    const glm::vec3 renderCameraPos = editorMode
+        ? globalConfig.cameraPos
+        : glm::mix(previousState.cameraPos, currentState.cameraPos, simAlpha);
+
+    packet.hasFrame = true;
+    packet.editorMode = editorMode;
+    packet.config = globalConfig;
+    packet.cameraPos = renderCameraPos;
+
+    // --- ATUALIZAÇÃO DAS MATRIZES DE CÂMERA ---
+    // A matriz 'view' transforma as coordenadas do mundo para o espaço da câmera.
+    packet.view = glm::lookAt(
+        renderCameraPos,                                    // eye: posição da câmera no mundo (interpolada)
+        renderCameraPos + globalConfig.cameraFront,         // center: ponto para onde a câmera está olhando
+        cameraUp                                            // up: vetor que define a direção “para cima”
+    );
+
+    // A matriz 'projection' define o frustum de visão (perspectiva).
+    // View frustum (ou simplesmente frustum de visão) é o volume em forma de pirâmide truncada que define tudo o que a câmera “vê” na cena 3D. Ele é limitado por:
+    // Near plane (plano próximo): o plano mais próximo da câmera onde a renderização começa (distância mínima).
+    // Far plane (plano distante): o plano mais afastado da câmera onde a renderização termina (distância máxima).
+    packet.projection = glm::perspective(
+        glm::radians(globalConfig.fov),           // fov: campo de visão vertical da câmera (em graus convertido para radianos)
+        static_cast<float>(WIDTH) / HEIGHT,       // aspect ratio: proporção entre largura e altura da viewport
+        globalConfig.nearPlane,                   // nearPlane: distância mínima do plano de corte próximo do frustum
+        globalConfig.farPlane                     // farPlane: distância máxima do plano de corte distante do frustum
+    );
+
+    if (editorMode) {
+        packet.editorPoints = editorControlPoints;
+        packet.editorLevels = editorPointYellowLevels;
+        return;
     }
-    // Define a área de renderização para cobrir toda a janela.
-    glViewport(0, 0, WIDTH, HEIGHT);
-    // Habilita o teste de profundidade, para que objetos mais próximos cubram os mais distantes.
-    glEnable(GL_DEPTH_TEST);
 
-    // --- COMPILAÇÃO DOS SHADERS ---
-    // Instancia os shaders usando a classe wrapper.
-    Shader objectShader(vertexShaderSource, fragmentShaderSource, true); // Shader para os objetos 3D.
-    Shader lineShader("../shaders/Line.vs", "../shaders/Line.fs");       // Shader simples para linhas e pontos.
+    // Desenha todas as Object3D carregadas na cena.
+    packet.items.reserve(meshes.size());
+    for (auto& pair : meshes) {
+        const Object3D& obj = pair.second;
+        glm::mat4 model(1.0f);
+
+        // Requisito 3d: Animação do carro
+        // Lógica especial para o objeto chamado "Carro".
+        auto currentPose = currentState.poses.find(obj.name);
+        if (obj.name == "Carro" && currentPose != currentState.poses.end()) {
+            // Pose do carro interpolada entre os dois últimos passos da simulação
+            // (ver simulationStep: modo por distância, por amostras ou em streaming).
+            auto previousPose = previousState.poses.find(obj.name);
+            AnimatedPose pose = currentPose->second;
+            if (previousPose != previousState.poses.end()) {
+                pose.position = glm::mix(previousPose->second.position, pose.position, simAlpha);
+                pose.orientation = glm::slerp(previousPose->second.orientation, pose.orientation, simAlpha);
+            }
 
-    // --- CONFIGURAÇÃO INICIAL DA CENA ---
-    // Define valores padrão para câmera, luz e outros parâmetros.
-    // Estes valores podem ser sobrescritos ao carregar um arquivo de cena.
-    globalConfig.cameraPos = glm::vec3(0.0f, 5.0f, 10.0f);
-    globalConfig.cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
-    globalConfig.lightPos = glm::vec3(10.0f, 10.0f, 10.0f);
-    globalConfig.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
-    globalConfig.fov = 45.0f;
-    globalConfig.nearPlane = 0.1f;
-    globalConfig.farPlane = 100.0f;
-    globalConfig.sensitivity = 0.1f;
-    globalConfig.cameraSpeed = 0.05f;
-    globalConfig.attConstant = 1.0f;
-    globalConfig.attLinear = 0.09f;
-    globalConfig.attQuadratic = 0.032f;
-    globalConfig.fogColor = glm::vec3(0.5f, 0.5f, 0.5f);
-    globalConfig.fogStart = 5.0f;
-    globalConfig.fogEnd = 50.0f;
+            // A matriz de modelo final é a composição de Escala -> Rotação -> Translação.
+            // A ordem é importante: primeiro escalamos o objeto em sua origem, depois rotacionamos, e por fim transladamos para a posição final.
+            model = glm::translate(glm::mat4(1.0f), pose.position)
+                * glm::mat4_cast(pose.orientation) * carBasisMirror
+                * glm::scale(glm::mat4(1.0f), obj.scale);
+        }
+        else {
+            // Para objetos estáticos (como a pista), aplica apenas a translação definida.
+            model = glm::translate(glm::mat4(1.0f), obj.position);
+        }
 
-    lastFrameTime = glfwGetTime();
-    animAccumulator = 0.0f;
+        // Aplica rotações e escala adicionais (se houver, para objetos estáticos).
+        model = glm::rotate(model, glm::radians(obj.angle.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(obj.angle.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(obj.angle.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        // Aplica escala
+        model = glm::scale(model, obj.scale);
+
+        DrawItem item;
+        item.model = model;
+        item.material = obj.material;
+        item.textureID = obj.textureID;
+        item.VAO = obj.getMesh().VAO;
+        item.indexCount = obj.getMesh().indexCount;
+        item.vertexCount = static_cast<GLsizei>(obj.getMesh().vertexCount());
+        item.chunkedTrack = obj.drawsTrackChunks;
+        item.shaderFeatures = objectShaderFeatures(obj.material, obj.textureID, globalConfig);
+        packet.items.push_back(item);
+    }
+    // Agrupa os itens por variante do shader (mantendo a ordem dentro de cada grupo), para que
+    // a thread de renderização troque de programa uma vez por variante, não por objeto.
+    std::stable_sort(packet.items.begin(), packet.items.end(),
+        [](const DrawItem& a, const DrawItem& b) { return a.shaderFeatures < b.shaderFeatures; });
+
+    packet.showCurves = showCurves != 0;
+    if (packet.showCurves) {
+        for (const auto& pair : bSplineCurves) {
+            const BSplineCurve& bc = pair.second;
+            CurveItem curve;
+            curve.VAO = bc.VAO;
+            curve.controlPointsVAO = bc.controlPointsVAO;
+            curve.curveCount = static_cast<GLsizei>(bc.curvePoints.size());
+            curve.controlCount = static_cast<GLsizei>(bc.controlPoints.size());
+            curve.color = bc.color;
+            packet.curves.push_back(curve);
+        }
+    }
+}
 
-    // --- LOOP DE RENDERIZAÇÃO ---
-    // O coração da aplicação. Roda continuamente até que a janela seja fechada.
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents(); // Processa eventos de input (teclado, mouse).
+/**
+ * @brief Libera a prévia da pista (thread de renderização).
+ */
+static void releaseTrackPreview()
+{
+    deleteVertexArrayAndBuffers(trackPreviewBuffers.centerLineVAO);
+    deleteVertexArrayAndBuffers(trackPreviewBuffers.meshVAO);
+    trackPreviewBuffers = TrackPreviewBuffers();
+}
 
-        // Limpa os buffers de cor e profundidade a cada novo frame.
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glPointSize(10); // Define o tamanho dos pontos a serem renderizados (para os pontos de controle).
+/**
+ * @brief Substitui a prévia da pista pela etapa recebida (thread de renderização).
+ * @details Roda como comando de um FramePacket, entre dois frames: nenhum frame desenha
+ * uma prévia pela metade.
+ */
+static void uploadTrackPreview(const TrackPreview& step)
+{
+    releaseTrackPreview();
+    if (!step.centerLine.empty()) {
+        trackPreviewBuffers.centerLineVAO = uploadLineStrip(step.centerLine);
+        trackPreviewBuffers.centerLineCount = static_cast<GLsizei>(step.centerLine.size());
+    }
+    if (!step.indices.empty()) {
+        trackPreviewBuffers.meshVAO = setupGeometry(step.vertices, step.indices);
+        trackPreviewBuffers.meshIndexCount = static_cast<GLsizei>(step.indices.size());
+    }
+}
 
-        // --- CÁLCULO DE TEMPO ---
-        double now = glfwGetTime();
-        float  deltaTime = static_cast<float>(now - lastFrameTime);
-        lastFrameTime = now;
-        animAccumulator += deltaTime; // Acumula o tempo para a animação.
+/**
+ * @struct GpuPasses
+ * @brief Passadas medidas pelo GpuProfiler (identificadores de `addPass`).
+ */
+struct GpuPasses {
+    int frame = 0, objects = 0, track = 0, curves = 0, editor = 0;
+};
+static GpuPasses gpuPasses;
 
-        // --- ATUALIZAÇÃO DAS MATRIZES DE CÂMERA ---
-        // A matriz 'view' transforma as coordenadas do mundo para o espaço da câmera.
-        glm::mat4 view = glm::lookAt(
-            globalConfig.cameraPos,                             // eye: posição da câmera no mundo
-            globalConfig.cameraPos + globalConfig.cameraFront,  // center: ponto para onde a câmera está olhando
-            cameraUp                                            // up: vetor que define a direção “para cima”
-        );
-
-        // A matriz 'projection' define o frustum de visão (perspectiva).
-        // View frustum (ou simplesmente frustum de visão) é o volume em forma de pirâmide truncada que define tudo o que a câmera “vê” na cena 3D. Ele é limitado por:
-        // Near plane (plano próximo): o plano mais próximo da câmera onde a renderização começa (distância mínima).
-        // Far plane (plano distante): o plano mais afastado da câmera onde a renderização termina (distância máxima).
-        glm::mat4 projection = glm::perspective(
-            glm::radians(globalConfig.fov),           // fov: campo de visão vertical da câmera (em graus convertido para radianos)
-            static_cast<float>(WIDTH) / HEIGHT,       // aspect ratio: proporção entre largura e altura da viewport
-            globalConfig.nearPlane,                   // nearPlane: distância mínima do plano de corte próximo do frustum
-            globalConfig.farPlane                     // farPlane: distância máxima do plano de corte distante do frustum
-        );
-
-        // --- LÓGICA DE RENDERIZAÇÃO CONDICIONAL (EDITOR vs. VISUALIZADOR) ---
-        if (editorMode) {
-            // --- MODO EDITOR ---
-            // Renderiza apenas os pontos de controle da pista.
-            glUseProgram(lineShader.getId());
-            // Envia as matrizes de câmera para o shader de linhas.
-            glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "view"), 1, GL_FALSE, glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-            if (!editorControlPoints.empty()) {
-                // Gera/atualiza o buffer com os pontos de controle e o desenha.
-                GLuint VAO = generateControlPointsBuffer(editorControlPoints);
-                glBindVertexArray(VAO);
-
-                // Desenha cada ponto de controle com uma cor baseada na sua altura ("nível de amarelo").
-                for (size_t i = 0; i < editorControlPoints.size(); ++i) {
-                    float yl = editorPointYellowLevels[i];
-                    float t = glm::clamp(yl / maxHeight, 0.0f, 1.0f); // Normaliza a altura para o intervalo [0,1].
-                    float brightness = 0.2f + 0.8f * t; // Mapeia a altura para um brilho entre 0.2 e 1.0.
-                    glUniform4f(glGetUniformLocation(lineShader.getId(), "finalColor"), brightness, brightness, 0.0f, 1.0f);
-                    glDrawArrays(GL_POINTS, (GLint)i, 1); // Desenha um único ponto.
-                }
+/**
+ * @brief Imprime as estatísticas de GPU de cada passada e, se `csv` não for nulo, acrescenta
+ * uma linha por passada ao arquivo (thread de renderização).
+ */
+static void reportGpuStats(const GpuProfiler& profiler, FILE* csv, const std::string& renderer)
+{
+    std::cout << "GPU (" << profiler.measuredFrames() << " frames medidos, "
+        << profiler.droppedFrames() << " descartados):\n";
+    const std::time_t now = std::time(nullptr);
+    for (const GpuPassStats& pass : profiler.stats()) {
+        if (pass.samples == 0)
+            continue;
+        std::printf("  %-8s media %7.3f ms | p50 %7.3f | p95 %7.3f | p99 %7.3f | max %7.3f (%zu amostras)\n",
+            pass.name, pass.averageMs, pass.p50Ms, pass.p95Ms, pass.p99Ms, pass.maxMs, pass.samples);
+        if (csv)
+            std::fprintf(csv, "%lld,%s %s,\"%s\",%s,%zu,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                static_cast<long long>(now), __DATE__, __TIME__, renderer.c_str(), pass.name, pass.samples,
+                pass.averageMs, pass.p50Ms, pass.p95Ms, pass.p99Ms, pass.maxMs);
+    }
+    std::fflush(stdout);
+    if (csv)
+        std::fflush(csv);
+}
 
-                glBindVertexArray(0);
+/**
+ * @brief Desenha um FramePacket (thread de renderização).
+ * @param gpu Mede o tempo de GPU das passadas; nulo se `--gpu-stats` não foi pedido.
+ */
+static void drawFrame(const FramePacket& frame, ShaderVariants& objectShaders, Shader& lineShader, GpuProfiler* gpu)
+{
+    const GlobalConfig& config = frame.config;
+    GpuProfiler::Scope frameScope(gpu, gpuPasses.frame);
+
+    // Limpa os buffers de cor e profundidade a cada novo frame.
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glPointSize(10); // Define o tamanho dos pontos a serem renderizados (para os pontos de controle).
+
+    // --- LÓGICA DE RENDERIZAÇÃO CONDICIONAL (EDITOR vs. VISUALIZADOR) ---
+    if (frame.editorMode) {
+        GpuProfiler::Scope editorScope(gpu, gpuPasses.editor);
+        // --- MODO EDITOR ---
+        // Renderiza apenas os pontos de controle da pista.
+        glUseProgram(lineShader.getId());
+        // Envia as matrizes de câmera para o shader de linhas.
+        glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "view"), 1, GL_FALSE, glm::value_ptr(frame.view));
+        glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "projection"), 1, GL_FALSE, glm::value_ptr(frame.projection));
+
+        // Prévia da pista em geração (se houver): a malha em cinza e a linha central por cima.
+        if (trackPreviewBuffers.meshVAO) {
+            glUniform4f(glGetUniformLocation(lineShader.getId(), "finalColor"), 0.4f, 0.4f, 0.4f, 1.0f);
+            glBindVertexArray(trackPreviewBuffers.meshVAO);
+            glDrawElements(GL_TRIANGLES, trackPreviewBuffers.meshIndexCount, GL_UNSIGNED_INT, (GLvoid*)0);
+        }
+        if (trackPreviewBuffers.centerLineVAO) {
+            glUniform4f(glGetUniformLocation(lineShader.getId(), "finalColor"), 1.0f, 0.0f, 0.0f, 1.0f);
+            glBindVertexArray(trackPreviewBuffers.centerLineVAO);
+            glDrawArrays(GL_LINE_STRIP, 0, trackPreviewBuffers.centerLineCount);
+        }
+        glBindVertexArray(0);
+
+        if (!frame.editorPoints.empty()) {
+            // Gera/atualiza o buffer com os pontos de controle e o desenha.
+            GLuint VAO = generateControlPointsBuffer(frame.editorPoints);
+            glBindVertexArray(VAO);
+
+            // Desenha cada ponto de controle com uma cor baseada na sua altura ("nível de amarelo").
+            for (size_t i = 0; i < frame.editorPoints.size(); ++i) {
+                float yl = frame.editorLevels[i];
+                float t = glm::clamp(yl / maxHeight, 0.0f, 1.0f); // Normaliza a altura para o intervalo [0,1].
+                float brightness = 0.2f + 0.8f * t; // Mapeia a altura para um brilho entre 0.2 e 1.0.
+                glUniform4f(glGetUniformLocation(lineShader.getId(), "finalColor"), brightness, brightness, 0.0f, 1.0f);
+                glDrawArrays(GL_POINTS, (GLint)i, 1); // Desenha um único ponto.
             }
+
+            glBindVertexArray(0);
         }
-        else {
-            // --- MODO VISUALIZADOR ---
-            // Renderiza a cena 3D completa.
-
-            // Movimentação da câmera baseada nas flags de input.
-            if (moveW)
-                globalConfig.cameraPos += globalConfig.cameraFront * globalConfig.cameraSpeed;
-            if (moveA)
-                globalConfig.cameraPos -= glm::normalize(glm::cross(globalConfig.cameraFront, cameraUp)) * globalConfig.cameraSpeed;
-            if (moveS)
-                globalConfig.cameraPos -= globalConfig.cameraFront * globalConfig.cameraSpeed;
-            if (moveD)
-                globalConfig.cameraPos += glm::normalize(glm::cross(globalConfig.cameraFront, cameraUp)) * globalConfig.cameraSpeed;
-
-            // Requisito 3: Visualizador 3D
-            // Ativa o shader principal e envia todas as uniforms globais (luz, fog, câmera, etc.).
+        return;
+    }
+
+    // --- MODO VISUALIZADOR ---
+    // Renderiza a cena 3D completa.
+
+    // Requisito 3: Visualizador 3D
+    // Os itens chegam agrupados por variante do shader. A cada troca de variante, ativa o
+    // programa dela e envia as uniforms globais (luz, fog, câmera, etc.). Uniforms que a
+    // variante não tem (ex.: fog) têm localização -1 e são ignoradas pelo OpenGL.
+    GpuProfiler::Scope objectsScope(gpu, gpuPasses.objects);
+    Shader* active = nullptr;
+    for (const DrawItem& item : frame.items) {
+        Shader& objectShader = objectShaders.get(item.shaderFeatures);
+        if (active != &objectShader) {
+            active = &objectShader;
             glUseProgram(objectShader.getId());
-            glUniformMatrix4fv(glGetUniformLocation(objectShader.getId(), "view"), 1, GL_FALSE, glm::value_ptr(view));
-            glUniformMatrix4fv(glGetUniformLocation(objectShader.getId(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-            glUniform3fv(glGetUniformLocation(objectShader.getId(), "lightPos"), 1, glm::value_ptr(globalConfig.lightPos));
-            glUniform3fv(glGetUniformLocation(objectShader.getId(), "lightColor"), 1, glm::value_ptr(globalConfig.lightColor));
-            glUniform3fv(glGetUniformLocation(objectShader.getId(), "cameraPos"), 1, glm::value_ptr(globalConfig.cameraPos));
-            glUniform3fv(glGetUniformLocation(objectShader.getId(), "fogColor"), 1, glm::value_ptr(globalConfig.fogColor));
-            glUniform1f(glGetUniformLocation(objectShader.getId(), "fogStart"), globalConfig.fogStart);
-            glUniform1f(glGetUniformLocation(objectShader.getId(), "fogEnd"), globalConfig.fogEnd);
-            glUniform1f(glGetUniformLocation(objectShader.getId(), "attConstant"), globalConfig.attConstant);
-            glUniform1f(glGetUniformLocation(objectShader.getId(), "attLinear"), globalConfig.attLinear);
-            glUniform1f(glGetUniformLocation(objectShader.getId(), "attQuadratic"), globalConfig.attQuadratic);
-
-            // Desenha todas as Object3D carregadas na cena.
-            float lastCarYaw = 0.0f;
-            for (auto& pair : meshes) {
-                Object3D& obj = pair.second;
-                glm::mat4  model(1.0f);
-
-                // Requisito 3d: Animação do carro
-                // Lógica especial para o objeto chamado "Carro".
-                if (obj.name == "Carro" && obj.animationPositions.size() >= 3) {
-                    int N = static_cast<int>(obj.animationPositions.size());
-                    int idx = animationIndex % N;
-                    int prevIdx = (idx - 1 + N) % N; // Índice anterior com wrap-around (evita valores negativos).
-                    int nextIdx = (idx + 1) % N;     // Próximo índice com wrap-around.
-
-                    glm::vec3 P = obj.animationPositions[prevIdx];  // Ponto anterior
-                    glm::vec3 C = obj.animationPositions[idx];      // Ponto atual (posição do carro)
-                    glm::vec3 Np = obj.animationPositions[nextIdx]; // Próximo ponto
-
-                    // A direção do carro é a tangente à curva, aproximada pelo vetor entre o ponto seguinte e o anterior.
-                    glm::vec3 dir = glm::normalize(Np - P);
-
-                    // --- CONSTRUÇÃO DE UMA BASE ORTONORMAL ---
-                    // Para orientar o carro corretamente, precisamos de 3 eixos: frente, direita e cima.
-                    glm::vec3 forward = dir;
-                    // O vetor 'direita' é perpendicular ao 'frente' e ao 'cima' do mundo (Y-up).
-                    glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
-                    // O vetor 'cima' do carro é perpendicular ao 'frente' e ao 'direita'. Isso permite o "banking" (inclinação) do carro nas curvas e subidas.
-                    glm::vec3 upAxis = glm::cross(right, forward);
-
-                    // A matriz de rotação pode ser construída diretamente com os vetores da base ortonormal como suas colunas.
-                    glm::mat4 rot(1.0f);
-                    rot[0] = glm::vec4(right, 0.0f);
-                    rot[1] = glm::vec4(upAxis, 0.0f);
-                    rot[2] = glm::vec4(forward, 0.0f);
-
-                    // A matriz de modelo final é a composição de Escala -> Rotação -> Translação.
-                    // A ordem é importante: primeiro escalamos o objeto em sua origem, depois rotacionamos, e por fim transladamos para a posição final.
-                    model = glm::translate(glm::mat4(1.0f), C)
-                        * rot
-                        * glm::scale(glm::mat4(1.0f), obj.scale);
-                }
-                else {
-                    // Para objetos estáticos (como a pista), aplica apenas a translação definida.
-                    model = glm::translate(glm::mat4(1.0f), obj.position);
-                }
+            glUniformMatrix4fv(glGetUniformLocation(objectShader.getId(), "view"), 1, GL_FALSE, glm::value_ptr(frame.view));
+            glUniformMatrix4fv(glGetUniformLocation(objectShader.getId(), "projection"), 1, GL_FALSE, glm::value_ptr(frame.projection));
+            glUniform3fv(glGetUniformLocation(objectShader.getId(), "lightPos"), 1, glm::value_ptr(config.lightPos));
+            glUniform3fv(glGetUniformLocation(objectShader.getId(), "lightColor"), 1, glm::value_ptr(config.lightColor));
+            glUniform3fv(glGetUniformLocation(objectShader.getId(), "cameraPos"), 1, glm::value_ptr(frame.cameraPos));
+            glUniform3fv(glGetUniformLocation(objectShader.getId(), "fogColor"), 1, glm::value_ptr(config.fogColor));
+            glUniform1f(glGetUniformLocation(objectShader.getId(), "fogStart"), config.fogStart);
+            glUniform1f(glGetUniformLocation(objectShader.getId(), "fogEnd"), config.fogEnd);
+            glUniform1f(glGetUniformLocation(objectShader.getId(), "attConstant"), config.attConstant);
+            glUniform1f(glGetUniformLocation(objectShader.getId(), "attLinear"), config.attLinear);
+            glUniform1f(glGetUniformLocation(objectShader.getId(), "attQuadratic"), config.attQuadratic);
+        }
 
-                // Aplica rotações e escala adicionais (se houver, para objetos estáticos).
-                model = glm::rotate(model, glm::radians(obj.angle.x), glm::vec3(1.0f, 0.0f, 0.0f));
-                model = glm::rotate(model, glm::radians(obj.angle.y), glm::vec3(0.0f, 1.0f, 0.0f));
-                model = glm::rotate(model, glm::radians(obj.angle.z), glm::vec3(0.0f, 0.0f, 1.0f));
-                // Aplica escala
-                model = glm::scale(model, obj.scale);
-
-                // Envia a matriz de modelo e as propriedades do material do objeto para o shader.
-                glUniformMatrix4fv(glGetUniformLocation(objectShader.getId(), "model"), 1, GL_FALSE, glm::value_ptr(model));
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "kaR"), obj.material.kaR);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "kaG"), obj.material.kaG);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "kaB"), obj.material.kaB);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "kdR"), obj.material.kdR);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "kdG"), obj.material.kdG);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "kdB"), obj.material.kdB);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "ksR"), obj.material.ksR);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "ksG"), obj.material.ksG);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "ksB"), obj.material.ksB);
-                glUniform1f(glGetUniformLocation(objectShader.getId(), "ns"), obj.material.ns);
-
-                // --- RENDERIZAÇÃO DO OBJETO ---
-                // O VAO contém todas as informações de buffer (VBO) e layout de atributos.
-                GLuint vao = obj.getMesh().VAO;
-                size_t vertCount = obj.getMesh().vertices.size();
-                glBindVertexArray(vao); // Ativa o VAO do objeto.
-                glActiveTexture(GL_TEXTURE0);         // Ativa a unidade de textura 0.
-                glBindTexture(GL_TEXTURE_2D, obj.textureID); // Vincula a textura do objeto a essa unidade.
-                glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertCount)); // Desenha!
-                glBindVertexArray(0); // Desvincula o VAO para evitar modificações acidentais.
+        // Envia a matriz de modelo e as propriedades do material do objeto para o shader.
+        glUniformMatrix4fv(glGetUniformLocation(objectShader.getId(), "model"), 1, GL_FALSE, glm::value_ptr(item.model));
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "kaR"), item.material.kaR);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "kaG"), item.material.kaG);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "kaB"), item.material.kaB);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "kdR"), item.material.kdR);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "kdG"), item.material.kdG);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "kdB"), item.material.kdB);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "ksR"), item.material.ksR);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "ksG"), item.material.ksG);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "ksB"), item.material.ksB);
+        glUniform1f(glGetUniformLocation(objectShader.getId(), "ns"), item.material.ns);
+
+        // --- RENDERIZAÇÃO DO OBJETO ---
+        // O VAO contém todas as informações de buffer (VBO) e layout de atributos.
+        glActiveTexture(GL_TEXTURE0);         // Ativa a unidade de textura 0.
+        glBindTexture(GL_TEXTURE_2D, item.textureID); // Vincula a textura do objeto a essa unidade.
+        if (item.chunkedTrack && !trackChunks.empty()) {
+            GpuProfiler::Scope trackScope(gpu, gpuPasses.track);
+            // A pista gerada é desenhada por blocos: cada bloco fora do frustum é descartado
+            // e os visíveis usam um LOD escolhido pela distância até a câmera.
+            // Frustum e câmera são levados para o espaço do objeto da pista (onde estão as AABBs).
+            Frustum frustum = Frustum::fromMatrix(frame.projection * frame.view * item.model);
+            glm::vec3 localCamera = glm::vec3(glm::inverse(item.model) * glm::vec4(frame.cameraPos, 1.0f));
+            for (const TrackChunk& chunk : trackChunks.chunks) {
+                if (!frustum.intersectsAABB(chunk.boundsMin, chunk.boundsMax))
+                    continue;
+                const Mesh& lod = chunk.lods[trackChunks.selectLod(chunk, localCamera)];
+                glBindVertexArray(lod.VAO);
+                glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT, (GLvoid*)0);
             }
+        }
+        else {
+            glBindVertexArray(item.VAO); // Ativa o VAO do objeto.
+            // Malhas com buffer de índices (EBO) são desenhadas com glDrawElements; as lidas de .obj, com glDrawArrays.
+            if (item.indexCount > 0)
+                glDrawElements(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, (GLvoid*)0);
+            else
+                glDrawArrays(GL_TRIANGLES, 0, item.vertexCount); // Desenha!
+        }
+        glBindVertexArray(0); // Desvincula o VAO para evitar modificações acidentais.
+    }
 
-            // Desenha curvas B-Spline (para debug).
-            if (showCurves) {
-                glUseProgram(lineShader.getId());
-                glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "view"), 1, GL_FALSE, glm::value_ptr(view));
-                glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-                for (const auto& pair : bSplineCurves) {
-                    const BSplineCurve& bc = pair.second;
-                    // Desenha a linha da curva
-                    glUniform4fv(glGetUniformLocation(lineShader.getId(), "finalColor"), 1, glm::value_ptr(bc.color));
-                    glBindVertexArray(bc.VAO);
-                    glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(bc.curvePoints.size()));
-                    glBindVertexArray(0);
-
-                    // Desenha os pontos de controle em amarelo
-                    glUniform4f(glGetUniformLocation(lineShader.getId(), "finalColor"), 1.0f, 1.0f, 0.0f, 1.0f);
-                    glBindVertexArray(bc.controlPointsVAO);
-                    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(bc.controlPoints.size()));
-                    glBindVertexArray(0);
-                }
-            }
+    // Desenha curvas B-Spline (para debug).
+    if (frame.showCurves) {
+        GpuProfiler::Scope curvesScope(gpu, gpuPasses.curves);
+        glUseProgram(lineShader.getId());
+        glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "view"), 1, GL_FALSE, glm::value_ptr(frame.view));
+        glUniformMatrix4fv(glGetUniformLocation(lineShader.getId(), "projection"), 1, GL_FALSE, glm::value_ptr(frame.projection));
+        for (const CurveItem& curve : frame.curves) {
+            // Desenha a linha da curva
+            glUniform4fv(glGetUniformLocation(lineShader.getId(), "finalColor"), 1, glm::value_ptr(curve.color));
+            glBindVertexArray(curve.VAO);
+            glDrawArrays(GL_LINE_STRIP, 0, curve.curveCount);
+            glBindVertexArray(0);
+
+            // Desenha os pontos de controle em amarelo
+            glUniform4f(glGetUniformLocation(lineShader.getId(), "finalColor"), 1.0f, 1.0f, 0.0f, 1.0f);
+            glBindVertexArray(curve.controlPointsVAO);
+            glDrawArrays(GL_POINTS, 0, curve.controlCount);
+            glBindVertexArray(0);
+        }
+    }
+}
 
-            // Atualiza a animação do carro usando o acumulador de tempo.
-            if (!meshes["Carro"].animationPositions.empty()) {
-                while (animAccumulator >= STEP_TIME) {
-                    animationIndex = (animationIndex + 1) % meshes["Carro"].animationPositions.size();
-                    animAccumulator -= STEP_TIME;
-                }
+/**
+ * @struct RenderSurface
+ * @brief Onde a thread de renderização desenha: a janela GLFW, uma janela oculta ou, com
+ * GRAUB_EGL, um contexto EGL sem superfície. Fora da janela visível (`offscreen`), os frames
+ * vão para um FBO do tamanho da janela e não são apresentados.
+ */
+struct RenderSurface {
+    GLFWwindow* window = nullptr;
+    bool        offscreen = false;
+#ifdef GRAUB_EGL
+    EGLDisplay  eglDisplay = EGL_NO_DISPLAY;
+    EGLContext  eglContext = EGL_NO_CONTEXT;
+#endif
+
+    void makeCurrent() const
+    {
+#ifdef GRAUB_EGL
+        if (eglContext != EGL_NO_CONTEXT) {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext);
+            return;
+        }
+#endif
+        glfwMakeContextCurrent(window);
+    }
+
+    void releaseCurrent() const
+    {
+#ifdef GRAUB_EGL
+        if (eglContext != EGL_NO_CONTEXT) {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            return;
+        }
+#endif
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    GLADloadproc loader() const
+    {
+#ifdef GRAUB_EGL
+        if (eglContext != EGL_NO_CONTEXT)
+            return (GLADloadproc)eglGetProcAddress;
+#endif
+        return (GLADloadproc)glfwGetProcAddress;
+    }
+
+    void fail() const
+    {
+        if (window)
+            glfwSetWindowShouldClose(window, GL_TRUE);
+    }
+};
+
+/**
+ * @brief Corpo da thread de renderização: dona do contexto OpenGL do início ao fim.
+ * @details Consome os pacotes da `frameQueue`, executando primeiro os comandos OpenGL de cada
+ * um, e desenha o retrato mais recente. Se nenhum pacote novo chegou (a thread principal
+ * está ocupada, por exemplo gerando a pista), redesenha o último: a apresentação não para.
+ * @param ready Recebe true quando o contexto e o alvo de desenho estão prontos, ou false se a
+ * inicialização falhou (a thread já terminou). Só então a thread principal envia comandos.
+ */
+static void renderThreadMain(RenderSurface surface, std::promise<bool>* ready)
+{
+    // Em qualquer saída, avisa quem espera por comandos (postRenderCommand/runOnRenderThread).
+    struct ExitSignal { ~ExitSignal() { renderExited = true; } } exitSignal;
+    Profiler::setThreadName("renderizacao");
+    surface.makeCurrent();
+    if (!surface.offscreen)
+        glfwSwapInterval(uncappedBenchmark ? 0 : 1);
+
+    // Inicializa o GLAD para carregar as funções do OpenGL. Essencial para usar OpenGL moderno.
+    if (!gladLoadGLLoader(surface.loader())) {
+        std::cerr << "Falha ao inicializar GLAD\n";
+        surface.fail();
+        renderFailed = true;
+        ready->set_value(false);
+        return;
+    }
+
+    // Fora da janela, desenha num FBO do mesmo tamanho (cor + profundidade).
+    GLuint offscreenFBO = 0, offscreenTargets[2] = { 0, 0 };
+    if (surface.offscreen) {
+        glGenFramebuffers(1, &offscreenFBO);
+        glGenRenderbuffers(2, offscreenTargets);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenTargets[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenTargets[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, WIDTH, HEIGHT);
+        glBindFramebuffer(GL_FRAMEBUFFER, offscreenFBO);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenTargets[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, offscreenTargets[1]);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Falha ao criar o framebuffer do modo headless\n";
+            surface.fail();
+            renderFailed = true;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &offscreenFBO);
+            glDeleteRenderbuffers(2, offscreenTargets);
+            surface.releaseCurrent();
+            ready->set_value(false);
+            return;
+        }
+    }
+    // Define a área de renderização para cobrir toda a janela.
+    glViewport(0, 0, WIDTH, HEIGHT);
+    // Habilita o teste de profundidade, para que objetos mais próximos cubram os mais distantes.
+    glEnable(GL_DEPTH_TEST);
+    ready->set_value(true);
+
+    // --- COMPILAÇÃO DOS SHADERS ---
+    // Com o cache, os programas linkados em uma execução anterior (mesmos fontes, mesmo driver)
+    // são carregados prontos, sem compilar.
+    const auto shaderStart = std::chrono::steady_clock::now();
+    if (useShaderCache)
+        Shader::enableProgramCache(surface.loader(), SHADER_CACHE_DIRECTORY);
+    const bool parallelCompile = Shader::enableParallelCompile(surface.loader());
+    // Instancia os shaders usando a classe wrapper. Todas as variantes que
+    // `objectShaderFeatures` pode escolher são pedidas já, sem esperar: o driver as compila
+    // enquanto a thread principal carrega a cena, e o laço abaixo as conclui quando ficam prontas.
+    ShaderVariants objectShaders(vertexShaderSource, fragmentShaderSource); // Shaders para os objetos 3D.
+    for (unsigned features = 0; features <= (SHADER_FOG | SHADER_SPECULAR | SHADER_TEXTURED); ++features)
+        objectShaders.request(features);
+    Shader lineShader("../shaders/Line.vs", "../shaders/Line.fs");           // Shader simples para linhas e pontos.
+    bool shadersReported = false;
+
+    // --- TEMPO DE GPU (`--gpu-stats`) ---
+    GpuProfiler gpuProfiler;
+    GpuProfiler* gpu = gpuStats ? &gpuProfiler : nullptr;
+    FILE* gpuCsv = nullptr;
+    std::string renderer;
+    auto lastGpuReport = std::chrono::steady_clock::now();
+    if (gpu) {
+        gpuPasses.frame = gpuProfiler.addPass("frame");
+        gpuPasses.objects = gpuProfiler.addPass("objetos");
+        gpuPasses.track = gpuProfiler.addPass("pista");
+        gpuPasses.curves = gpuProfiler.addPass("curvas");
+        gpuPasses.editor = gpuProfiler.addPass("editor");
+        const GLubyte* rendererName = glGetString(GL_RENDERER);
+        renderer = rendererName ? reinterpret_cast<const char*>(rendererName) : "";
+        std::replace(renderer.begin(), renderer.end(), '"', '\'');
+        if (!gpuStatsCsvPath.empty()) {
+            gpuCsv = std::fopen(gpuStatsCsvPath.c_str(), "a");
+            if (!gpuCsv)
+                std::cerr << "Falha ao abrir " << gpuStatsCsvPath << '\n';
+            else if (std::fseek(gpuCsv, 0, SEEK_END) == 0 && std::ftell(gpuCsv) == 0) // Arquivo novo: escreve o cabeçalho.
+                std::fputs("unix_time,build,renderer,pass,samples,avg_ms,p50_ms,p95_ms,p99_ms,max_ms\n", gpuCsv);
+        }
+    }
+
+    FramePacket frame;   // Último retrato recebido.
+    FramePacket packet;
+    bool haveFrame = false;
+    while (renderRunning.load()) {
+        bool newFrame = false;
+        while (frameQueue.tryPop(packet)) {
+            PROFILE_ZONE("render: comandos");
+            for (auto& command : packet.commands)
+                command();
+            packet.commands.clear();
+            if (packet.hasFrame) {
+                std::swap(frame, packet);
+                haveFrame = newFrame = true;
+                if (headlessMode)
+                    break; // No modo headless, cada pacote enviado é desenhado.
             }
         }
+        if (!shadersReported && objectShaders.finishReady() == 0) {
+            shadersReported = true;
+            std::cout << "Shaders prontos em "
+                << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - shaderStart).count()
+                << " ms (" << Shader::cachedPrograms() << " do cache, " << Shader::compiledPrograms() << " compilados"
+                << (parallelCompile ? ", em paralelo" : "") << ")\n";
+        }
+        if (!haveFrame || (headlessMode && !newFrame)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(headlessMode ? 0 : 1));
+            continue;
+        }
 
-        glfwSwapBuffers(window); // Troca o buffer de fundo (onde desenhamos) com o buffer da frente (o que é exibido).
+        const auto frameStart = std::chrono::steady_clock::now();
+        {
+            PROFILE_ZONE("drawFrame");
+            if (gpu) gpu->beginFrame();
+            drawFrame(frame, objectShaders, lineShader, gpu);
+            if (gpu) gpu->endFrame();
+        }
+        if (surface.offscreen) {
+            // Sem apresentação: espera a GPU terminar, para o tempo medido incluir o trabalho dela.
+            PROFILE_ZONE("glFinish");
+            glFinish();
+            headlessFrameTimes.push_back(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+            ++headlessFramesDrawn;
+        }
+        else {
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(surface.window); // Troca o buffer de fundo (onde desenhamos) com o buffer da frente (o que é exibido).
+        }
+        ++renderedFrames;
+
+        if (gpu && std::chrono::steady_clock::now() - lastGpuReport
+            >= std::chrono::duration<double>(GPU_REPORT_INTERVAL)) {
+            lastGpuReport = std::chrono::steady_clock::now();
+            reportGpuStats(gpuProfiler, gpuCsv, renderer);
+        }
     }
+    if (gpu && headlessMode)
+        reportGpuStats(gpuProfiler, gpuCsv, renderer); // Resumo final da execução.
+    if (gpuCsv)
+        std::fclose(gpuCsv);
+    gpuProfiler.release();
+
+    // Comandos enfileirados depois do último frame ainda são executados (podem liberar recursos).
+    while (frameQueue.tryPop(packet))
+        for (auto& command : packet.commands)
+            command();
 
     // --- LIBERAÇÃO DE RECURSOS ---
+    // A thread principal está esperando este término (join), então os dados da cena podem ser lidos aqui.
     for (const auto& pair : meshes) {
         glDeleteVertexArrays(1, &pair.second.getMesh().VAO);
         // Os VBOs são geralmente gerenciados pelo VAO, mas poderiam ser deletados aqui também se gerenciados separadamente.
@@ -519,16 +1351,693 @@ int main() {
         glDeleteVertexArrays(1, &pair.second.VAO);
         glDeleteVertexArrays(1, &pair.second.controlPointsVAO);
     }
+    trackChunks.release();
+    releaseTrackPreview();
 
     // --- libera o VAO/VBO dos pontos do editor ----------------------------
     if (gCtrlPtsVBO) glDeleteBuffers(1, &gCtrlPtsVBO);
     if (gCtrlPtsVAO) glDeleteVertexArrays(1, &gCtrlPtsVAO);
 
+    if (offscreenFBO) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &offscreenFBO);
+        glDeleteRenderbuffers(2, offscreenTargets);
+    }
+    surface.releaseCurrent();
+}
+
+// ============================================================================
+// FUNÇÃO PRINCIPAL
+// ============================================================================
+
+/**
+ * @brief Valores padrão da configuração global; um arquivo de cena só sobrescreve as chaves que contém.
+ */
+GlobalConfig defaultGlobalConfig()
+{
+    GlobalConfig config;
+    config.cameraPos = glm::vec3(0.0f, 5.0f, 10.0f);
+    config.cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+    config.lightPos = glm::vec3(10.0f, 10.0f, 10.0f);
+    config.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    config.fov = 45.0f;
+    config.nearPlane = 0.1f;
+    config.farPlane = 100.0f;
+    config.sensitivity = 0.1f;
+    config.cameraSpeed = 3.0f; // Unidades por segundo.
+    config.attConstant = 1.0f;
+    config.attLinear = 0.09f;
+    config.attQuadratic = 0.032f;
+    config.fogColor = glm::vec3(0.5f, 0.5f, 0.5f);
+    config.fogStart = 5.0f;
+    config.fogEnd = 50.0f;
+    return config;
+}
+
+int main(int argc, char** argv) {
+    // --- MODOS DE LINHA DE COMANDO (sem janela) ---
+    // `--pack-scene <cena.txt> <saida.pack>`: compila a cena e todos os arquivos que ela usa em um pacote único.
+    if (argc > 3 && std::string(argv[1]) == "--pack-scene")
+        return compileScenePack(argv[2], argv[3]);
+    // `--bench-fleet [carros] [frames]`: microbenchmark da atualização em lote das matrizes dos carros.
+    if (argc > 1 && std::string(argv[1]) == "--bench-fleet") {
+        long long carCount = 10000, frames = 600;
+        if ((argc > 2 && !parseIntegerArgument(argv[2], 1, 100000000, carCount))
+            || (argc > 3 && !parseIntegerArgument(argv[3], 1, 1000000, frames))) {
+            std::cerr << "Uso: --bench-fleet [carros (1 a 100000000)] [frames (1 a 1000000)]\n";
+            return -1;
+        }
+        runCarFleetBenchmark(static_cast<size_t>(carCount), static_cast<int>(frames));
+        return 0;
+    }
+    // `--bench-jobs [threads]`: microbenchmarks do JobSystem (criação, roubo, escalabilidade de 1 a `threads`).
+    if (argc > 1 && std::string(argv[1]) == "--bench-jobs") {
+        long long maxThreads = 64;
+        if (argc > 2 && !parseIntegerArgument(argv[2], 1, 1024, maxThreads)) {
+            std::cerr << "Uso: --bench-jobs [threads (1 a 1024)]\n";
+            return -1;
+        }
+        runJobSystemBenchmark(static_cast<unsigned int>(maxThreads));
+        return 0;
+    }
+    // `--bench-pipeline [opções]`: benchmarks do pipeline de arquivos (.obj, .mtl, curvas, pista,
+    // animação, cena) sobre entradas sintéticas, com JSON e comparação com uma baseline.
+    if (argc > 1 && std::string(argv[1]) == "--bench-pipeline")
+        return runPipelineBenchmark(argc, argv);
+
+    // `--uncapped`: sem vsync, reportando separadamente a taxa da simulação (Hz) e da renderização (FPS).
+    // `--no-save`: a cena gerada no editor não é gravada em disco (só usada em memória).
+    // `--no-shader-cache`: compila os shaders a partir dos fontes, sem usar nem gravar o cache.
+    // `--profile [arquivo.json]`: grava o perfil de CPU desde o início (padrão: profile.json).
+    // `--gpu-stats [arquivo.csv]`: imprime o tempo de GPU de cada passada e, com o arquivo,
+    // acrescenta as estatísticas a ele em CSV.
+    // `--scene <arquivo>`: abre direto no visualizador com a cena do arquivo (recarregada ao ser
+    // editada) ou de um pacote de cena (.pack).
+    // `--headless <cena> [frames]`: sem janela, desenha `frames` frames (padrão 600) da cena ao
+    // longo de um percurso de câmera e imprime as estatísticas do tempo de frame.
+    // `--camera-path <arquivo>`: percurso do modo headless (linhas "px py pz fx fy fz"); sem ele,
+    // a câmera dá uma volta em torno da cena.
+    std::string startupScene;
+    std::string headlessScene, cameraPathFile;
+    int headlessFrames = HEADLESS_DEFAULT_FRAMES;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--uncapped")
+            uncappedBenchmark = true;
+        else if (std::string(argv[i]) == "--no-save")
+            saveGeneratedScene = false;
+        else if (std::string(argv[i]) == "--no-shader-cache")
+            useShaderCache = false;
+        else if (std::string(argv[i]) == "--gpu-stats") {
+            gpuStats = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                gpuStatsCsvPath = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--profile") {
+            Profiler::setEnabled(true);
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                profilePath = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--scene" && i + 1 < argc)
+            startupScene = argv[++i];
+        else if (std::string(argv[i]) == "--headless" && i + 1 < argc) {
+            headlessScene = argv[++i];
+            long long frames = 0;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                if (!parseIntegerArgument(argv[++i], 1, 10000000, frames)) {
+                    std::cerr << "Uso: --headless <cena> [frames (1 a 10000000)] [--camera-path <arquivo>]\n";
+                    return -1;
+                }
+                headlessFrames = static_cast<int>(frames);
+            }
+        }
+        else if (std::string(argv[i]) == "--camera-path" && i + 1 < argc)
+            cameraPathFile = argv[++i];
+    }
+    if (!headlessScene.empty())
+        return runHeadless(headlessScene, headlessFrames, cameraPathFile);
+
+    // --- INICIALIZAÇÃO DO AMBIENTE GRÁFICO ---
+    // A janela e os eventos ficam na thread principal (exigência do GLFW); o contexto OpenGL
+    // da janela é assumido pela thread de renderização.
+    glfwInit();
+    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, WINDOW_TITLE, nullptr, nullptr);
+    assert(window && "Falha ao criar janela GLFW");
+
+    // Define as funções de callback que o GLFW chamará para tratar inputs.
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    // Requisito 2a: Cursor visível e normal no modo editor.
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+
+    // --- CONFIGURAÇÃO INICIAL DA CENA ---
+    // Define valores padrão para câmera, luz e outros parâmetros.
+    // Estes valores podem ser sobrescritos ao carregar um arquivo de cena.
+    globalConfig = defaultGlobalConfig();
+
+    // --- THREAD DE RENDERIZAÇÃO ---
+    Profiler::setThreadName("principal");
+    RenderSurface surface;
+    surface.window = window;
+    std::promise<bool> renderReady;
+    std::future<bool> renderStarted = renderReady.get_future();
+    std::thread renderThread(renderThreadMain, surface, &renderReady);
+    if (!renderStarted.get()) {
+        renderThread.join();
+        glfwTerminate();
+        return -1;
+    }
+
+    if (!startupScene.empty()) {
+        loadSceneIntoViewer(startupScene);
+        if (!editorMode)
+            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+
+    lastFrameTime = glfwGetTime();
+    animAccumulator = 0.0f;
+    resetSimulation();
+
+    // Contadores do modo de benchmark.
+    double statsStart = lastFrameTime;
+    int    statsSimSteps = 0;
+
+    // --- LOOP PRINCIPAL (EVENTOS + SIMULAÇÃO) ---
+    // Roda até que a janela seja fechada. Não desenha nada: produz um FramePacket por
+    // iteração para a thread de renderização.
+    while (!glfwWindowShouldClose(window)) {
+        PROFILE_ZONE("frame");
+        {
+            PROFILE_ZONE("glfwPollEvents");
+            glfwPollEvents(); // Processa eventos de input (teclado, mouse).
+        }
+        {
+            PROFILE_ZONE("pollTrackBuild");
+            pollTrackBuild(window); // Prévias e resultado da geração da pista em segundo plano.
+        }
+        if (!editorMode) {
+            PROFILE_ZONE("pollSceneReload");
+            pollSceneReload();  // Arquivos da cena modificados em disco.
+        }
+
+        // --- CÁLCULO DE TEMPO ---
+        double now = glfwGetTime();
+        float  frameTime = std::min(static_cast<float>(now - lastFrameTime), MAX_FRAME_TIME);
+        lastFrameTime = now;
+
+        // --- SIMULAÇÃO (PASSO FIXO) ---
+        // Consome o tempo real acumulado em passos de SIMULATION_STEP. Só há o que simular no visualizador.
+        if (!editorMode) {
+            PROFILE_ZONE("simulationStep");
+            simAccumulator += frameTime;
+            while (simAccumulator >= SIMULATION_STEP) {
+                simulationStep(SIMULATION_STEP);
+                simAccumulator -= SIMULATION_STEP;
+                ++statsSimSteps;
+            }
+        }
+
+        // --- ENVIO DO FRAME ---
+        // Se a thread de renderização ainda não consumiu os pacotes anteriores, não há por que
+        // montar outro agora: espera um pouco e volta a tratar eventos.
+        if (frameQueue.full()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        else {
+            PROFILE_ZONE("buildFramePacket");
+            FramePacket packet;
+            buildFramePacket(packet, simAccumulator / SIMULATION_STEP);
+            for (auto& release : pendingReleases)
+                packet.commands.push_back(std::move(release));
+            pendingReleases.clear();
+            frameQueue.tryPush(packet);
+        }
+
+        // --- ESTATÍSTICAS DO MODO DE BENCHMARK ---
+        if (uncappedBenchmark && now - statsStart >= 1.0) {
+            double elapsed = now - statsStart;
+            int frames = renderedFrames.exchange(0);
+            std::cout << "simulacao: " << statsSimSteps / elapsed << " Hz | renderizacao: "
+                << frames / elapsed << " FPS";
+            if (frames > 0)
+                std::cout << " (" << 1000.0 * elapsed / frames << " ms/frame)";
+            std::cout << '\n';
+            statsStart = now;
+            statsSimSteps = 0;
+        }
+    }
+
+    // --- ENCERRAMENTO ---
+    // A thread de renderização libera os recursos OpenGL (ela é a dona do contexto) e termina.
+    trackBuild.stop();
+    renderRunning = false;
+    renderThread.join();
+    if (pendingSave.valid())
+        pendingSave.wait(); // Não sai no meio da gravação da cena gerada.
+    if (Profiler::enabled())
+        writeProfile();
+
     glfwTerminate(); // Finaliza o GLFW, liberando todos os seus recursos.
-    return 0;
+    return renderFailed ? -1 : 0;
+}
+
+
+
+/**
+ * @brief Exporta as zonas gravadas pelo perfilador para `profilePath` (Chrome Trace Event JSON,
+ * abre em ui.perfetto.dev).
+ */
+void writeProfile()
+{
+    const long long zones = Profiler::writeChromeTrace(profilePath);
+    if (zones < 0)
+        std::cerr << "Falha ao gravar o perfil em " << profilePath << '\n';
+    else
+        std::cout << "Perfil gravado em " << profilePath << " (" << zones << " zonas)\n";
+}
+
+// ============================================================================
+// MODO HEADLESS
+// ============================================================================
+
+/**
+ * @brief Lê o percurso de câmera do modo headless: uma pose "px py pz fx fy fz" (posição e
+ * direção) por linha; linhas vazias e iniciadas por '#' são ignoradas.
+ */
+static bool readCameraPath(const std::string& path, std::vector<std::pair<glm::vec3, glm::vec3>>& keys)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Falha ao abrir o percurso de camera " << path << '\n';
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ss(line);
+        glm::vec3 pos, front;
+        if (ss >> pos.x >> pos.y >> pos.z >> front.x >> front.y >> front.z)
+            keys.push_back({ pos, glm::normalize(front) });
+    }
+    if (keys.empty())
+        std::cerr << "Percurso de camera vazio: " << path << '\n';
+    return !keys.empty();
+}
+
+#ifdef GRAUB_EGL
+/**
+ * @brief Contexto OpenGL 4.5 core sem superfície (EGL_MESA_platform_surfaceless): não precisa
+ * de janela nem de servidor gráfico. Retorna false se a plataforma não estiver disponível.
+ */
+static bool createSurfacelessContext(RenderSurface& surface)
+{
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = getPlatformDisplay
+        ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+        : EGL_NO_DISPLAY;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+        return false;
+    const EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4, EGL_CONTEXT_MINOR_VERSION, 5,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+    EGLContext context = EGL_NO_CONTEXT;
+    if (eglBindAPI(EGL_OPENGL_API))
+        context = eglCreateContext(display, nullptr, EGL_NO_CONTEXT, attributes);
+    if (context == EGL_NO_CONTEXT) {
+        eglTerminate(display);
+        return false;
+    }
+    surface.eglDisplay = display;
+    surface.eglContext = context;
+    return true;
+}
+#endif
+
+/**
+ * @brief Modo `--headless`: desenha `frames` frames da cena num FBO, sem janela visível nem
+ * input, e imprime as estatísticas do tempo de frame (CPU de desenho + glFinish).
+ * @details Usa o mesmo caminho do visualizador (thread de renderização, FramePacket, variantes
+ * de shader), então os números são comparáveis entre execuções e máquinas. A cada frame a
+ * simulação avança um SIMULATION_STEP e a câmera segue o percurso: o de `cameraPathFile`,
+ * interpolado ao longo dos frames, ou uma volta em torno do centro dos objetos, na distância e
+ * altura da câmera da cena. Os HEADLESS_WARMUP_FRAMES primeiros frames não entram nas
+ * estatísticas. O contexto é EGL sem superfície (com GRAUB_EGL) ou uma janela GLFW oculta.
+ * @return 0 em caso de sucesso; -1 se o contexto, a cena ou o desenho falharem.
+ */
+int runHeadless(const std::string& scenePath, int frames, const std::string& cameraPathFile)
+{
+    std::vector<std::pair<glm::vec3, glm::vec3>> cameraKeys;
+    if (!cameraPathFile.empty() && !readCameraPath(cameraPathFile, cameraKeys))
+        return -1;
+
+    headlessMode = true;
+    RenderSurface surface;
+    surface.offscreen = true;
+    bool glfwStarted = false;
+#ifdef GRAUB_EGL
+    if (!createSurfacelessContext(surface))
+        std::cerr << "EGL sem superficie indisponivel; usando uma janela oculta\n";
+    if (surface.eglContext == EGL_NO_CONTEXT)
+#endif
+    {
+        glfwStarted = glfwInit() == GLFW_TRUE;
+        if (glfwStarted) {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            surface.window = glfwCreateWindow(WIDTH, HEIGHT, WINDOW_TITLE, nullptr, nullptr);
+        }
+        if (!surface.window) {
+            std::cerr << "Falha ao criar o contexto OpenGL do modo headless\n";
+            if (glfwStarted) glfwTerminate();
+            return -1;
+        }
+    }
+
+    Profiler::setThreadName("principal");
+    globalConfig = defaultGlobalConfig();
+    std::promise<bool> renderReady;
+    std::future<bool> renderStarted = renderReady.get_future();
+    std::thread renderThread(renderThreadMain, surface, &renderReady);
+
+    const int totalFrames = HEADLESS_WARMUP_FRAMES + frames;
+    bool ok = false;
+    const auto loadStart = std::chrono::steady_clock::now();
+    const bool started = renderStarted.get(); // Sem a thread de renderização, a carga esperaria para sempre.
+    if (!started)
+        std::cerr << "Falha ao iniciar a renderizacao do modo headless\n";
+    else
+        loadSceneIntoViewer(scenePath);
+    if (started && editorMode)
+        std::cerr << "Falha ao carregar a cena " << scenePath << '\n';
+    else if (started) {
+        std::cout << "Cena carregada em " << std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - loadStart).count() << " ms; desenhando "
+            << frames << " frames (+" << HEADLESS_WARMUP_FRAMES << " de aquecimento)\n";
+        ok = true;
+
+        // Órbita padrão: em torno do centro dos objetos, na distância e altura da câmera da cena.
+        glm::vec3 center(0.0f);
+        for (const auto& pair : meshes)
+            center += pair.second.position;
+        if (!meshes.empty())
+            center /= static_cast<float>(meshes.size());
+        const glm::vec3 offset = globalConfig.cameraPos - center;
+        const float radius = std::max(glm::length(glm::vec2(offset.x, offset.z)), 1.0f);
+        const float startAngle = std::atan2(offset.z, offset.x);
+
+        resetSimulation();
+        for (int i = 0; i < totalFrames && !renderFailed; ++i) {
+            // Progresso no percurso; o aquecimento fica parado no início.
+            const float t = (i < HEADLESS_WARMUP_FRAMES || frames < 2) ? 0.0f
+                : static_cast<float>(i - HEADLESS_WARMUP_FRAMES) / (frames - 1);
+            if (!cameraKeys.empty()) {
+                const float k = t * (cameraKeys.size() - 1);
+                const size_t a = std::min(static_cast<size_t>(k), cameraKeys.size() - 1);
+                const size_t b = std::min(a + 1, cameraKeys.size() - 1);
+                globalConfig.cameraPos = glm::mix(cameraKeys[a].first, cameraKeys[b].first, k - a);
+                globalConfig.cameraFront = glm::normalize(glm::mix(cameraKeys[a].second, cameraKeys[b].second, k - a));
+            }
+            else {
+                const float angle = startAngle + t * glm::two_pi<float>();
+                globalConfig.cameraPos = center + glm::vec3(radius * std::cos(angle), offset.y, radius * std::sin(angle));
+                globalConfig.cameraFront = glm::normalize(center - globalConfig.cameraPos);
+            }
+
+            simulationStep(SIMULATION_STEP);
+            FramePacket packet;
+            buildFramePacket(packet, 1.0f);
+            for (auto& release : pendingReleases)
+                packet.commands.push_back(std::move(release));
+            pendingReleases.clear();
+            while (!frameQueue.tryPush(packet) && !renderFailed)
+                std::this_thread::yield();
+        }
+        while (headlessFramesDrawn.load() < totalFrames && !renderFailed)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    renderRunning = false;
+    renderThread.join();
+    ok = ok && !renderFailed;
+
+    if (ok) {
+        // A thread de renderização já terminou: os tempos podem ser lidos aqui.
+        std::vector<double> times(headlessFrameTimes.begin() + std::min<size_t>(HEADLESS_WARMUP_FRAMES, headlessFrameTimes.size()),
+            headlessFrameTimes.end());
+        std::sort(times.begin(), times.end());
+        double sum = 0.0;
+        for (double ms : times) sum += ms;
+        auto percentile = [&](double p) { return times[static_cast<size_t>(p * (times.size() - 1) + 0.5)]; };
+        if (!times.empty()) {
+            const double average = sum / times.size();
+            std::cout << std::fixed << std::setprecision(3)
+                << "frames: " << times.size() << " | media: " << average << " ms | p50: " << percentile(0.50)
+                << " ms | p95: " << percentile(0.95) << " ms | p99: " << percentile(0.99)
+                << " ms | min: " << times.front() << " ms | max: " << times.back() << " ms | "
+                << std::setprecision(1) << 1000.0 / average << " FPS\n";
+        }
+    }
+    if (Profiler::enabled())
+        writeProfile();
+
+#ifdef GRAUB_EGL
+    if (surface.eglContext != EGL_NO_CONTEXT) {
+        eglDestroyContext(surface.eglDisplay, surface.eglContext);
+        eglTerminate(surface.eglDisplay);
+    }
+#endif
+    if (surface.window)
+        glfwDestroyWindow(surface.window);
+    if (glfwStarted)
+        glfwTerminate();
+    return ok ? 0 : -1;
+}
+
+// ============================================================================
+// BENCHMARKS DO PIPELINE DE ARQUIVOS
+// ============================================================================
+
+// Entradas sintéticas geradas a cada execução (sempre as mesmas, para um tamanho).
+const std::string BENCH_DATA_DIRECTORY = "bench_data";
+// OBJWriter::write procura cada vértice com std::find (custo quadrático): tamanhos maiores não terminam.
+const uint64_t    BENCH_MAX_WRITE_FACES = 10000;
+static volatile float benchSink = 0.0f; // Impede o compilador de descartar os resultados.
+
+/**
+ * @brief Grava um .obj de `faces` triângulos: uma grade com relevo, no formato "f v/t/n" e com
+ * um `usemtl`, como os exportados pelo editor.
+ */
+static void writeSyntheticObj(const std::string& path, uint64_t faces)
+{
+    const uint64_t quads = (faces + 1) / 2;
+    const uint64_t columns = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::sqrt(static_cast<double>(quads)))));
+    const uint64_t rows = (quads + columns - 1) / columns;
+
+    std::ofstream file(path);
+    file << "# " << faces << " faces\n";
+    for (uint64_t r = 0; r <= rows; ++r) {
+        for (uint64_t c = 0; c <= columns; ++c) {
+            const float x = static_cast<float>(c), z = static_cast<float>(r);
+            file << "v " << x << ' ' << 0.25f * std::sin(0.3f * x) * std::cos(0.2f * z) << ' ' << z << '\n'
+                << "vt " << x / columns << ' ' << z / rows << '\n'
+                << "vn 0 1 0\n";
+        }
+    }
+    file << "usemtl BenchMaterial\n";
+    uint64_t written = 0;
+    for (uint64_t r = 0; r < rows && written < faces; ++r) {
+        for (uint64_t c = 0; c < columns && written < faces; ++c) {
+            const uint64_t a = r * (columns + 1) + c + 1, b = a + 1, d = a + columns + 1, e = d + 1;
+            file << "f " << a << '/' << a << '/' << a << ' ' << d << '/' << d << '/' << d << ' ' << b << '/' << b << '/' << b << '\n';
+            if (++written < faces)
+                file << "f " << b << '/' << b << '/' << b << ' ' << d << '/' << d << '/' << d << ' ' << e << '/' << e << '/' << e << '\n';
+            ++written;
+        }
+    }
+}
+
+/**
+ * @brief Grava um .mtl com `materials` blocos (setupMtl lê todos; o último vale).
+ */
+static void writeSyntheticMtl(const std::string& path, uint64_t materials)
+{
+    std::ofstream file(path);
+    for (uint64_t m = 0; m < materials; ++m) {
+        const float t = static_cast<float>(m % 100) / 100.0f;
+        file << "newmtl BenchMaterial" << m << "\n"
+            << "Ka " << 0.1f * t << ' ' << 0.1f << ' ' << 0.1f << "\n"
+            << "Kd " << t << ' ' << 0.5f << ' ' << 1.0f - t << "\n"
+            << "Ks 0.5 0.5 0.5\n"
+            << "Ns " << 8.0f + 56.0f * t << "\n";
+    }
 }
 
+/**
+ * @brief `count` pontos de controle em um laço com elevação, como os clicados no editor.
+ */
+static std::vector<glm::vec3> syntheticControlPoints(uint64_t count)
+{
+    std::vector<glm::vec3> points;
+    points.reserve(count);
+    for (uint64_t k = 0; k < count; ++k) {
+        const float a = glm::two_pi<float>() * k / count;
+        const float radius = 0.8f + 0.15f * std::sin(5.0f * a);
+        points.emplace_back(radius * std::cos(a), radius * std::sin(a), 0.5f + 0.5f * std::sin(3.0f * a));
+    }
+    return points;
+}
+
+/**
+ * @brief Benchmarks do lado de CPU do pipeline de arquivos, sobre entradas sintéticas de tamanho
+ * controlado (gravadas em BENCH_DATA_DIRECTORY). Executado com `--bench-pipeline`.
+ * @details Opções: `--runs N` (padrão 10), `--warmup N` (padrão 2), `--max-faces N` (maior .obj
+ * lido; padrão 1000000, até 10000000), `--timer wall|cpu`, `--json <arquivo>` (grava os
+ * resultados), `--baseline <arquivo>` (compara as medianas com um JSON anterior) e
+ * `--threshold <porcentagem>` (variação tolerada; padrão 10).
+ * "readSceneFile" mede a parte de CPU da leitura da cena (parseSceneFile, loadSceneObjects e
+ * buildBSplineCurve), sem os envios à GPU.
+ * @return 0; 1 se algum caso regrediu além da tolerância; -1 em erro de uso ou de arquivo.
+ */
+int runPipelineBenchmark(int argc, char** argv)
+{
+    long long runs = 10, warmup = 2, maxFaces = 1000000, thresholdPercent = 10;
+    std::string jsonPath, baselinePath, timer = "wall";
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        bool valid = true;
+        if (arg == "--runs" && hasValue) valid = parseIntegerArgument(argv[++i], 1, 100000, runs);
+        else if (arg == "--warmup" && hasValue) valid = parseIntegerArgument(argv[++i], 0, 100000, warmup);
+        else if (arg == "--max-faces" && hasValue) valid = parseIntegerArgument(argv[++i], 1000, 10000000, maxFaces);
+        else if (arg == "--timer" && hasValue) timer = argv[++i];
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) valid = parseIntegerArgument(argv[++i], 0, 1000, thresholdPercent);
+        else {
+            std::cerr << "Opcao desconhecida para --bench-pipeline: " << arg << '\n';
+            return -1;
+        }
+        if (!valid) {
+            std::cerr << "Valor invalido para " << arg << ": " << argv[i] << '\n';
+            return -1;
+        }
+    }
+    const double threshold = thresholdPercent / 100.0;
+    if (timer != "wall" && timer != "cpu") {
+        std::cerr << "--timer deve ser wall ou cpu\n";
+        return -1;
+    }
+    std::vector<BenchmarkResult> baseline;
+    if (!baselinePath.empty() && !BenchmarkSuite::readJson(baselinePath, baseline)) {
+        std::cerr << "Falha ao ler a baseline " << baselinePath << '\n';
+        return -1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(BENCH_DATA_DIRECTORY, error);
+    const std::string dir = BENCH_DATA_DIRECTORY + "/";
+    BenchmarkSuite suite(static_cast<int>(warmup), static_cast<int>(runs), timer == "cpu" ? benchThreadCpuClock : benchWallClock);
+    std::printf("%lld repeticoes (+%lld de aquecimento), relogio %s\n", runs, warmup, timer.c_str());
+
+    // --- .mtl ---
+    const std::string mtlPath = dir + "bench.mtl";
+    writeSyntheticMtl(mtlPath, 1);
+    for (uint64_t materials : { 1ull, 1000ull, 100000ull }) {
+        const std::string path = dir + "materials_" + std::to_string(materials) + ".mtl";
+        writeSyntheticMtl(path, materials);
+        suite.run("setupMtl", materials, [&] { benchSink = benchSink + setupMtl(path).ns; });
+    }
+
+    // --- .obj (leitura e escrita) ---
+    std::unique_ptr<Object3D> parsed;
+    for (uint64_t faces = 1000; faces <= static_cast<uint64_t>(maxFaces); faces *= 10) {
+        const std::string objPath = dir + "mesh_" + std::to_string(faces) + ".obj";
+        writeSyntheticObj(objPath, faces);
+        // A destruição do objeto anterior fica fora da medição.
+        suite.run("objParse", faces,
+            [&] { parsed.reset(new Object3D("Bench", objPath, mtlPath, glm::vec3(1.0f), glm::vec3(0.0f),
+                glm::vec3(0.0f), glm::vec3(0.0f), 0, /*upload_=*/false)); },
+            [&] { parsed.reset(); });
+        if (faces <= BENCH_MAX_WRITE_FACES) {
+            const Object3D source("Bench", objPath, mtlPath, glm::vec3(1.0f), glm::vec3(0.0f),
+                glm::vec3(0.0f), glm::vec3(0.0f), 0, /*upload_=*/false);
+            const std::string outPath = dir + "written_" + std::to_string(faces) + ".obj";
+            suite.run("OBJWriter::write", faces, [&] { OBJWriter().write(source.getMesh(), outPath); });
+        }
+    }
+    parsed.reset();
+
+    // --- curva, pista e animação ---
+    const int pointsPerSegment = 50;
+    std::vector<glm::vec3> curvePoints;
+    for (uint64_t controls : { 16ull, 256ull, 4096ull }) {
+        const std::vector<glm::vec3> controlPoints = syntheticControlPoints(controls);
+        suite.run("generateBSplinePoints", controls, [&] {
+            curvePoints = generateBSplinePoints(controlPoints, pointsPerSegment);
+            benchSink = benchSink + curvePoints.back().x;
+        });
+    }
+    // Com 4096 pontos de controle, a curva tem ~200 mil pontos: os tamanhos abaixo são prefixos dela.
+    for (uint64_t points : { 1000ull, 10000ull, 100000ull }) {
+        const std::vector<glm::vec3> center(curvePoints.begin(), curvePoints.begin() + std::min<size_t>(points, curvePoints.size()));
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        suite.run("generateTrackMesh", points, [&] {
+            generateTrackMesh(center, 0.1f, vertices, indices);
+            benchSink = benchSink + vertices.back().x;
+        });
+        const std::string textPath = dir + "animation_" + std::to_string(points) + ".txt";
+        const std::string binaryPath = dir + "animation_" + std::to_string(points) + ".anim";
+        suite.run("exportAnimation(txt)", points, [&] { exportAnimationPoints(center, textPath); });
+        suite.run("exportAnimation(anim)", points, [&] { exportAnimationPoints(center, binaryPath); });
+    }
+
+    // --- cena completa ---
+    const uint64_t sceneFaces = std::min<uint64_t>(maxFaces, 10000);
+    const std::string sceneObj = dir + "mesh_" + std::to_string(sceneFaces) + ".obj";
+    writeSyntheticObj(sceneObj, sceneFaces);
+    for (uint64_t objects : { 1ull, 8ull, 32ull }) {
+        const std::string scenePath = dir + "scene_" + std::to_string(objects) + ".txt";
+        {
+            std::ofstream scene(scenePath);
+            scene << "Type GlobalConfig Config\nCameraPos 0.0 5.0 10.0\nFogStart 5.0\nFogEnd 50.0\nEnd\n";
+            for (uint64_t k = 0; k < objects; ++k)
+                scene << "Type Mesh Objeto" << k << "\nObj " << sceneObj << "\nMtl " << mtlPath
+                    << "\nScale 1.0 1.0 1.0\nPosition " << 2.0f * k << " 0.0 0.0\nEnd\n";
+            scene << "Type BSplineCurve Curva\n";
+            for (const glm::vec3& p : syntheticControlPoints(64))
+                scene << "ControlPoint " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+            scene << "PointsPerSegment 50\nColor 1.0 0.0 0.0 1.0\nEnd\n";
+        }
+        suite.run("readSceneFile", objects, [&] {
+            SceneDesc scene;
+            scene.config = defaultGlobalConfig();
+            if (!parseSceneFile(scenePath, scene))
+                return;
+            std::vector<SceneObjectDesc> meshDescs;
+            for (const SceneObjectDesc& desc : scene.objects)
+                if (desc.type == "Mesh") meshDescs.push_back(desc);
+            std::vector<Object3D> loaded = loadSceneObjects(meshDescs);
+            for (const SceneObjectDesc& desc : scene.objects)
+                if (desc.type == "BSplineCurve")
+                    benchSink = benchSink + static_cast<float>(buildBSplineCurve(desc.controlPoints, desc.pointsPerSegment).curvePoints.size());
+            benchSink = benchSink + static_cast<float>(loaded.size());
+        });
+    }
 
+    if (!jsonPath.empty()) {
+        if (!suite.writeJson(jsonPath, std::string(__DATE__) + " " + __TIME__, timer)) {
+            std::cerr << "Falha ao gravar " << jsonPath << '\n';
+            return -1;
+        }
+        std::cout << "Resultados gravados em " << jsonPath << '\n';
+    }
+    if (!baselinePath.empty()) {
+        const int regressions = suite.compare(baseline, threshold);
+        std::printf("%d regressao(oes) acima de %.0f%%\n", regressions, 100.0 * threshold);
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
 
 // ============================================================================
 // CALLBACKS DE INPUT E LÓGICA DE MOUSE
@@ -543,6 +2052,10 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     // — adjust yellow/height in editor:
     if (editorMode && action == GLFW_PRESS) {
         // Teclas +/- para aumentar/diminuir a altura do último ponto de controle adicionado.
+        if (trackBuild.running() && (key == GLFW_KEY_KP_ADD || key == GLFW_KEY_EQUAL
+            || key == GLFW_KEY_KP_SUBTRACT || key == GLFW_KEY_MINUS))
+            cancelTrackBuild(window); // Os pontos mudaram: a pista em geração ficou desatualizada.
+
         if (key == GLFW_KEY_KP_ADD || key == GLFW_KEY_EQUAL) {
             currentYellowLevel =
                 glm::clamp(currentYellowLevel + yellowStep, 0.0f, maxHeight);
@@ -579,6 +2092,21 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     else if (key == GLFW_KEY_D && action == GLFW_RELEASE)
         moveD = false;
     
+    // Tecla M alterna entre a animação por distância (velocidade constante) e a animação por amostras.
+    if (key == GLFW_KEY_M && action == GLFW_PRESS)
+        constantSpeedAnimation = !constantSpeedAnimation;
+
+    // F9: liga o perfilador de CPU; com ele ligado, exporta o que foi gravado até agora.
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+        if (!Profiler::enabled()) {
+            Profiler::setEnabled(true);
+            std::cout << "Perfil de CPU ligado (F9 de novo grava " << profilePath << ")\n";
+        }
+        else {
+            writeProfile();
+        }
+    }
+
     // Requisito 2: Alternar entre editor e visualizador
     // --- MUDANÇA DE MODO (EDITOR -> VISUALIZADOR) ---
     if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
@@ -596,47 +2124,73 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
                 ctrlPoints3D.emplace_back(p.x, p.y, yl);
             }
             
-            // 2. Gera a curva B-Spline suave e a malha da pista a partir dela.
-            // spline & mesh:
-            auto curvePoints = generateBSplinePoints(ctrlPoints3D, 50);
-            std::vector<Vertex>      vertices;
-            std::vector<unsigned int> indices;
-            generateTrackMesh(curvePoints, trackWidth, vertices, indices);
-
-            // 3. CRÍTICO: Transforma a pista do plano XY (editor) para o plano XZ (visualizador).
-            // Cria um novo vetor de Vertex “trackVerts” aplicando Y↔Z
-            std::vector<Vertex> trackVerts;
-            trackVerts.reserve(vertices.size());
-            for (const auto& v : vertices) {
-                // Posição: (x, y, z) -> (v.x, v.z, v.y)
-                // Normal: (nx, ny, nz) -> (v.nx, v.nz, v.ny)
-                trackVerts.push_back({
-                    v.x, v.z, v.y,    // swapped y<->z
-                    v.s, v.t,
-                    v.nx, v.nz, v.ny  // swapped normal y<->z
-                    });
-            }
-            
-            // 4. Constrói o objeto Mesh da pista e o salva em "track.obj".
-            // Constrói diretamente o Mesh de “track”:
-            Mesh trackMesh(trackVerts, indices, /*groupName=*/"track", /*mtlName=*/"");
+            // 2. A geração (curva, malha, cena) roda em segundo plano: este callback volta na
+            //    hora e a janela continua respondendo. O loop principal acompanha a geração
+            //    (pollTrackBuild), mostra as prévias e, no fim, passa ao modo visualizador.
+            //    Pressionar espaço de novo recomeça a geração.
+            trackBuild.start(ctrlPoints3D, trackWidth, trackChunkLength);
+        }
+    }
+}
 
-            // Grava “track.obj” com OBJWriter:
-            OBJWriter objWriter;
-            objWriter.write(trackMesh, "track.obj");
+/**
+ * @brief Acompanha a geração da pista (thread principal).
+ * @details Repassa cada prévia nova à thread de renderização, mostra a etapa atual no título
+ * da janela e, quando a cena fica pronta, a grava (se ativo), a instala e passa ao modo visualizador.
+ */
+void pollTrackBuild(GLFWwindow* window)
+{
+    static int shownStages = -1; // Etapas concluídas exibidas no título.
+    if (!trackBuild.running()) {
+        shownStages = -1;
+        return;
+    }
 
-            // 5. Exporta os pontos da curva para a animação e gera o arquivo de cena completo.
-            exportAnimationPoints(curvePoints, "animation.txt");
-            generateSceneFile("track.obj", "car.obj", "animation.txt", "Scene.txt", editorControlPoints);
-            
-            // 6. Lê o arquivo de cena recém-criado para popular o modo visualizador.
-            readSceneFile("Scene.txt", &meshes, &meshList, &bSplineCurves, &globalConfig); // Agora acessa as globais
-            
-            // 7. Alterna para o modo visualizador e captura o cursor do mouse para a câmera mouselook.
-            editorMode = false;
-            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        }
+    TrackPreview step;
+    if (trackBuild.takePreview(step)) {
+        // std::function precisa ser copiável: a prévia vai num shared_ptr.
+        auto shared = std::make_shared<TrackPreview>(std::move(step));
+        postRenderCommand([shared] { uploadTrackPreview(*shared); });
     }
+
+    const int done = trackBuild.stagesDone();
+    if (done != shownStages && done < TRACK_STAGE_COUNT) {
+        std::ostringstream title;
+        title << WINDOW_TITLE << " - gerando pista: " << TRACK_STAGE_NAMES[done]
+            << " (" << done + 1 << '/' << TRACK_STAGE_COUNT << ')';
+        glfwSetWindowTitle(window, title.str().c_str());
+        shownStages = done;
+    }
+
+    GeneratedScene scene;
+    if (!trackBuild.takeResult(scene))
+        return;
+
+    // Opcionalmente, grava track.obj, animation.anim e Scene.txt em segundo plano,
+    // para a cena poder ser reaberta depois.
+    if (saveGeneratedScene)
+        saveGeneratedSceneAsync(scene.track.getMesh(), scene.animationPoints, scene.controlPoints);
+
+    // Passa os dados gerados direto para o modo visualizador, sem reler os arquivos.
+    installGeneratedScene(scene);
+    postRenderCommand(releaseTrackPreview);
+    glfwSetWindowTitle(window, WINDOW_TITLE);
+
+    // Alterna para o modo visualizador e captura o cursor do mouse para a câmera mouselook.
+    editorMode = false;
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    resetSimulation(); // A cena mudou: os estados simulados anteriores não valem mais.
+}
+
+/**
+ * @brief Cancela a geração da pista em andamento e apaga sua prévia.
+ */
+void cancelTrackBuild(GLFWwindow* window)
+{
+    trackBuild.cancel();
+    postRenderCommand(releaseTrackPreview);
+    glfwSetWindowTitle(window, WINDOW_TITLE);
+    std::cout << "Geracao da pista cancelada\n";
 }
 
 /**
@@ -648,6 +2202,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 // Requisito 2a: Captura de cliques do mouse para pontos de controle no editor 2D
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (editorMode && button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+        if (trackBuild.running())
+            cancelTrackBuild(window); // Um ponto novo desatualiza a pista em geração.
+
         double xpos, ypos;
         glfwGetCursorPos(window, &xpos, &ypos);
 
@@ -750,23 +2307,53 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
  * @brief Cria a estrutura BSplineCurve com seu VAO/VBO correspondente para renderização.
  */
 BSplineCurve createBSplineCurve(std::vector<glm::vec3> controlPoints, int pointsPerSegment)
+{
+    BSplineCurve bc = buildBSplineCurve(controlPoints, pointsPerSegment);
+    uploadBSplineCurve(bc);
+    return bc;
+}
+
+/**
+ * @brief Monta a BSplineCurve só em CPU (pontos da curva e tabela de comprimento de arco).
+ */
+BSplineCurve buildBSplineCurve(const std::vector<glm::vec3>& controlPoints, int pointsPerSegment)
 {
     BSplineCurve bc;
+    bc.controlPoints = controlPoints;
+    bc.pointsPerSegment = pointsPerSegment;
     // Gera os pontos da curva.
     bc.curvePoints = generateBSplinePoints(controlPoints, pointsPerSegment);
+    // Tabela de comprimento de arco, para consultas O(log n) por distância ao longo da curva.
+    bc.arcLength = ArcLengthTable(controlPoints);
+    return bc;
+}
+
+/**
+ * @brief Cria os VAOs da curva e dos seus pontos de controle (thread dona do contexto OpenGL).
+ */
+void uploadBSplineCurve(BSplineCurve& bc)
+{
+    bc.VAO = uploadLineStrip(bc.curvePoints);
+    bc.controlPointsVAO = generateControlPointsBuffer(bc.controlPoints);
+}
+
+/**
+ * @brief Cria um VAO/VBO com uma sequência de pontos (atributo 0), para desenhar como linha.
+ */
+GLuint uploadLineStrip(const std::vector<glm::vec3>& points)
+{
     GLuint VBO, VAO;
     glGenBuffers(1, &VBO);
     glGenVertexArrays(1, &VAO);
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     // Usa GL_STATIC_DRAW como dica para o OpenGL, pois a curva, uma vez gerada, não muda.
-    glBufferData(GL_ARRAY_BUFFER, bc.curvePoints.size() * sizeof(glm::vec3), bc.curvePoints.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(glm::vec3), points.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
     glEnableVertexAttribArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-    bc.VAO = VAO;
-    return bc;
+    return VAO;
 }
 
 /**
@@ -777,6 +2364,7 @@ BSplineCurve createBSplineCurve(std::vector<glm::vec3> controlPoints, int points
  */
 // Requisito 2b: Geração de curva B-Spline a partir dos pontos de controle
 std::vector<glm::vec3> generateBSplinePoints(const std::vector<glm::vec3>& controlPoints, int pointsPerSegment) {
+    PROFILE_ZONE("generateBSplinePoints");
     std::vector<glm::vec3> curvePoints;
     if (controlPoints.size() < 4)
         return curvePoints; // Mínimo 4 pontos para B-Spline cúbica
@@ -816,112 +2404,491 @@ std::vector<glm::vec3> generateBSplinePoints(const std::vector<glm::vec3>& contr
 // Generate TrackMesh, AnimationPoints and SceneFile
 // ============================================================================
 /**
- * @brief Gera a malha 3D da pista a partir da linha central.
- * @details "Extruda" a linha central para os lados, calculando vetores perpendiculares
+ * @brief Vetor perpendicular (no plano XY) à linha central na amostra `i`.
+ * @details Em vez de calcular o ângulo do segmento com `atan2` e voltar com `cos`/`sin`,
+ * basta normalizar a direção do segmento (i -> i+1) e girá-la 90 graus: (dx, dy) -> (-dy, dx).
+ * O resultado aponta sempre para o mesmo lado da pista (a borda "interna"), sem a troca de
+ * lado que a correção por quadrante causava. Se o segmento for degenerado (pontos repetidos),
+ * usa o segmento anterior.
+ */
+static glm::vec3 trackPerpendicular(const std::vector<glm::vec3>& centerPoints, size_t i)
+{
+    const size_t n = centerPoints.size();
+    glm::vec2 dir(centerPoints[(i + 1) % n] - centerPoints[i % n]);
+    if (glm::dot(dir, dir) <= 1e-12f)
+        dir = glm::vec2(centerPoints[i % n] - centerPoints[(i + n - 1) % n]);
+
+    const float len2 = glm::dot(dir, dir);
+    if (len2 <= 1e-12f)
+        return glm::vec3(0.0f, 1.0f, 0.0f);
+    dir *= glm::inversesqrt(len2);
+    return glm::vec3(-dir.y, dir.x, 0.0f);
+}
+
+/**
+ * @brief Escreve os dois vértices (interno, externo) da amostra `k` da linha central.
+ * @param v Coordenada de textura ao longo da pista (comprimento de arco / largura).
+ * @param[out] out Ponteiro para dois Vertex consecutivos.
+ */
+static void writeTrackSample(const std::vector<glm::vec3>& centerPoints, size_t k,
+                             float halfWidth, float v, Vertex* out)
+{
+    const glm::vec3& A = centerPoints[k % centerPoints.size()];
+    const glm::vec3 offset = trackPerpendicular(centerPoints, k) * halfWidth;
+
+    // Os pontos da borda são o ponto central deslocado ao longo do vetor perpendicular.
+    // A altura (Z) é herdada do ponto central. Normal fixa = (0,0,1) ("para cima" no editor).
+    const glm::vec3 inner = A + offset;
+    const glm::vec3 outer = A - offset;
+    out[0] = { inner.x, inner.y, inner.z,  0.0f, v,  0.0f, 0.0f, 1.0f };
+    out[1] = { outer.x, outer.y, outer.z,  1.0f, v,  0.0f, 0.0f, 1.0f };
+}
+
+/**
+ * @brief Escreve os 6 índices (2 triângulos) do quad entre as amostras `k` e `k+1`.
+ * @details Com 2 vértices por amostra, a amostra k ocupa os vértices 2k (interno) e 2k+1 (externo).
+ */
+static void writeTrackQuad(size_t k, unsigned int* out)
+{
+    const unsigned int inner = static_cast<unsigned int>(2 * k);
+    const unsigned int outer = inner + 1;
+    const unsigned int nextInner = inner + 2;
+    const unsigned int nextOuter = inner + 3;
+
+    // A ordem dos índices define a orientação da face (sentido anti-horário é face frontal).
+    // 1º triângulo: (inner[k], inner[k+1], outer[k])
+    out[0] = inner;
+    out[1] = nextInner;
+    out[2] = outer;
+    // 2º triângulo: (outer[k], inner[k+1], outer[k+1])
+    out[3] = outer;
+    out[4] = nextInner;
+    out[5] = nextOuter;
+}
+
+/**
+ * @brief Gera a malha 3D (indexada) da pista a partir da linha central.
+ * @details "Extruda" a linha central para os lados, calculando um vetor perpendicular
  * em cada ponto para determinar as bordas interna e externa da pista.
- * Em seguida, conecta essas bordas para formar triângulos.
+ * Cada amostra gera exatamente dois vértices, compartilhados pelos quads vizinhos
+ * através do buffer de índices. A pista é fechada: o último quad liga a última amostra
+ * a uma cópia da primeira (costura), para que a coordenada V, que cresce continuamente
+ * com o comprimento de arco, não "volte" a zero no meio de um quad.
  * @param centerPoints Pontos da curva B-Spline que formam o centro da pista.
  * @param trackWidth A largura da pista.
- * @param[out] vertices Vetor de vértices da malha da pista a ser preenchido.
- * @param[out] indices Vetor de índices da malha da pista a ser preenchido.
+ * @param[out] vertices Vetor de vértices da malha da pista a ser preenchido (2 * (n + 1)).
+ * @param[out] indices Vetor de índices da malha da pista a ser preenchido (6 * n).
  */
 // Requisito 2c, 2d: Geração das curvas interna e externa da pista
-void generateTrackMesh(const std::vector<glm::vec3> centerPoints,
+void generateTrackMesh(const std::vector<glm::vec3>& centerPoints,
                        float trackWidth,
                        std::vector<Vertex>& vertices,
                        std::vector<unsigned int>& indices)
 {
+    PROFILE_ZONE("generateTrackMesh");
     vertices.clear();
     indices.clear();
     const float halfWidth = trackWidth * 0.5f;
-    size_t n = centerPoints.size();
+    const size_t n = centerPoints.size();
     if (n < 2) return;
 
-    // 1) Pre‐compute “inner” e “outer” offsets no plano XY
-    std::vector<glm::vec3> innerPoints(n), outerPoints(n);
-    for (size_t i = 0; i < n; ++i) {
-        glm::vec3 A = centerPoints[i];
-        glm::vec3 B = centerPoints[(i + 1) % n]; // Pega o próximo ponto (com wrap around para fechar a pista)
-
-        float dx = B.x - A.x;
-        float dy = B.y - A.y;
-        float theta = atan2(dy, dx); // Ângulo do segmento AB.
-        // ângulo perpendicular em relação ao segmento AB
-        // A lógica de `dx < 0` tenta corrigir problemas em diferentes quadrantes, embora
-        // um método mais simples seja usar um vetor perpendicular fixo (dy, -dx).
-        float alpha = (dx < 0.0f)
-            ? theta - glm::radians(90.0f)
-            : theta + glm::radians(90.0f);
-
-        float cosA = cos(alpha);
-        float sinA = sin(alpha);
-        glm::vec3 offset(cosA * halfWidth, sinA * halfWidth, 0.0f);
-
-        // Os pontos da borda são o ponto central deslocado ao longo do vetor perpendicular.
-        // A altura (Z) é herdada do ponto central.
-        innerPoints[i] = A + offset;  // borda interna
-        outerPoints[i] = A - offset;  // borda externa
-    }
-
-    // 2) Para cada segmento, crie um “quad” com 4 vértices (v0,v1,v2,v3)
-    //    e 2 triângulos, usando sempre as mesmas UVs: (0,0),(1,0),(1,1),(0,1).
-    //    Normal fixa = (0,0,1).
-    for (size_t i = 0; i < n; ++i) {
-        size_t next = (i + 1) % n;
-
-        // Pega os 4 pontos que formam um "quad" (retângulo) da pista.
-        glm::vec3 A = outerPoints[i];
-        glm::vec3 B = outerPoints[next];
-        glm::vec3 C = innerPoints[i];
-        glm::vec3 D = innerPoints[next];
-
-        // normal “para cima” (já que track está em Z=0)
-        glm::vec3 upNormal(0.0f, 0.0f, 1.0f);
-
-        // constrói 4 vértices do quad (sempre na ordem C, A, B, D):
-        Vertex v0 = { C.x, C.y, C.z,  0.0f, 0.0f,  upNormal.x, upNormal.y, upNormal.z }; // inner[i]
-        Vertex v1 = { A.x, A.y, A.z,  1.0f, 0.0f,  upNormal.x, upNormal.y, upNormal.z }; // outer[i]
-        Vertex v2 = { B.x, B.y, B.z,  1.0f, 1.0f,  upNormal.x, upNormal.y, upNormal.z }; // outer[i+1]
-        Vertex v3 = { D.x, D.y, D.z,  0.0f, 1.0f,  upNormal.x, upNormal.y, upNormal.z }; // inner[i+1]
-
-        // índice base antes de inserir esses 4 vértices
-        unsigned int base = static_cast<unsigned int>(vertices.size());
-        vertices.push_back(v0);
-        vertices.push_back(v1);
-        vertices.push_back(v2);
-        vertices.push_back(v3);
-
-        // Cria dois triângulos a partir dos 4 vértices para formar o quad.
-        // A ordem dos índices define a orientação da face (sentido anti-horário é face frontal).
-        // 1º triângulo: (v0=C, v3=D, v1=A)
-        indices.push_back(base + 0);
-        indices.push_back(base + 3);
-        indices.push_back(base + 1);
-
-        // 2º triângulo: (v1=A, v3=D, v2=B)
-        indices.push_back(base + 1);
-        indices.push_back(base + 3);
-        indices.push_back(base + 2);
-    }
-}
-
-/**
- * @brief Exporta os pontos de animação (a linha central da pista) para um arquivo de texto.
- * @details Realiza a importante troca de coordenadas Y e Z para alinhar com o
- * sistema de coordenadas do visualizador 3D, onde Y é a altura.
+    // A textura se repete a cada "largura de pista" percorrida, mantendo sua proporção.
+    const float uvScale = (trackWidth > 0.0f) ? 1.0f / trackWidth : 1.0f;
+
+    // 1) Dois vértices por amostra (+ a costura k == n, que repete a amostra 0).
+    vertices.resize(2 * (n + 1));
+    float distance = 0.0f;
+    for (size_t k = 0; k <= n; ++k) {
+        if (k > 0)
+            distance += glm::length(centerPoints[k % n] - centerPoints[k - 1]);
+        writeTrackSample(centerPoints, k, halfWidth, distance * uvScale, &vertices[2 * k]);
+    }
+
+    // 2) Um quad (2 triângulos) por segmento, reaproveitando os vértices das amostras.
+    indices.resize(6 * n);
+    for (size_t k = 0; k < n; ++k)
+        writeTrackQuad(k, &indices[6 * k]);
+}
+
+/**
+ * @brief Versão paralela de generateTrackMesh para linhas centrais muito longas.
+ * @details A linha central é particionada em fatias, processadas em três passos:
+ *  1. (paralelo) comprimento de cada segmento;
+ *  2. (serial)   soma prefixada dos comprimentos -> coordenada V de cada amostra;
+ *  3. (paralelo) vértices e índices de cada fatia, escritos diretamente nas faixas
+ *                pré-alocadas da saída. As bordas de cada fatia leem as amostras
+ *                vizinhas (somente leitura) para calcular a perpendicular.
+ * A soma prefixada é feita na mesma ordem do caminho serial e os vértices/índices usam
+ * as mesmas funções (writeTrackSample/writeTrackQuad), então o resultado é idêntico,
+ * bit a bit, ao de generateTrackMesh. Linhas curtas caem direto no caminho serial.
+ * As fatias são tarefas do JobSystem::shared(), várias por thread, para que o roubo de
+ * trabalho equilibre threads que fiquem para trás.
+ * @param threadCount Número de threads a considerar (0 = as do JobSystem::shared()).
+ * @param cancel Se não nulo e marcado, as fatias restantes retornam sem escrever e a malha
+ * fica incompleta (quem cancelou a descarta).
  */
-// Requisito 2i: Exportação dos pontos de animação
-void exportAnimationPoints(const std::vector<glm::vec3>& points, const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Falha ao criar " << filename << '\n';
+void generateTrackMeshParallel(const std::vector<glm::vec3>& centerPoints,
+                               float trackWidth,
+                               std::vector<Vertex>& vertices,
+                               std::vector<unsigned int>& indices,
+                               unsigned int threadCount,
+                               const std::atomic<bool>* cancel)
+{
+    PROFILE_ZONE("generateTrackMeshParallel");
+    // Abaixo disso, o custo de criar threads supera o ganho.
+    const size_t minParallelSamples = 16384;
+
+    JobSystem& jobs = JobSystem::shared();
+    if (threadCount == 0)
+        threadCount = jobs.threadCount();
+    const size_t n = centerPoints.size();
+    if (n < minParallelSamples || threadCount <= 1) {
+        generateTrackMesh(centerPoints, trackWidth, vertices, indices);
         return;
     }
 
-    for (const auto& p : points) {
-        // O editor cria a pista no plano XY (p.x, p.y), com a altura em p.z.
-        // O visualizador espera a pista no plano XZ, com a altura em Y.
-        // Portanto, gravamos: X=p.x, Y=p.z (altura), Z=p.y.
+    vertices.clear();
+    indices.clear();
+    const float halfWidth = trackWidth * 0.5f;
+    const float uvScale = (trackWidth > 0.0f) ? 1.0f / trackWidth : 1.0f;
+    const size_t grain = (n + 4 * threadCount - 1) / (4 * threadCount);
+    auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    // 1) Comprimento de cada segmento (k-1 -> k), incluindo o de fechamento (n-1 -> 0).
+    std::vector<float> distances(n + 1);
+    distances[0] = 0.0f;
+    jobs.parallelFor(n, grain, [&](size_t begin, size_t end) {
+        if (cancelled()) return;
+        for (size_t k = begin + 1; k <= end; ++k)
+            distances[k] = glm::length(centerPoints[k % n] - centerPoints[k - 1]);
+    });
+
+    if (cancelled()) return;
+
+    // 2) Soma prefixada (serial, mesma ordem de acumulação do caminho serial).
+    float distance = 0.0f;
+    for (size_t k = 1; k <= n; ++k) {
+        distance += distances[k];
+        distances[k] = distance;
+    }
+
+    // 3) Vértices (2 por amostra + costura) e índices (6 por segmento) de cada fatia.
+    vertices.resize(2 * (n + 1));
+    indices.resize(6 * n);
+    jobs.parallelFor(n, grain, [&](size_t begin, size_t end) {
+        if (cancelled()) return;
+        for (size_t k = begin; k < end; ++k) {
+            writeTrackSample(centerPoints, k, halfWidth, distances[k] * uvScale, &vertices[2 * k]);
+            writeTrackQuad(k, &indices[6 * k]);
+        }
+    });
+    writeTrackSample(centerPoints, n, halfWidth, distances[n] * uvScale, &vertices[2 * n]);
+}
+
+/**
+ * @brief Leva vértices da pista do plano XY (editor) para o plano XZ (visualizador), trocando Y↔Z.
+ * @details Posição: (x, y, z) -> (x, z, y). Normal: (nx, ny, nz) -> (nx, nz, ny).
+ */
+void swapTrackYZ(std::vector<Vertex>& vertices)
+{
+    for (auto& v : vertices) {
+        std::swap(v.y, v.z);
+        std::swap(v.ny, v.nz);
+    }
+}
+
+/**
+ * @brief Divide a pista em blocos de comprimento fixo, cada um com TRACK_LOD_COUNT níveis de detalhe.
+ * @details As bordas dos blocos caem na primeira amostra em que o comprimento de arco acumulado
+ * passa de um múltiplo de `chunkLength`. Cada LOD dizima as amostras do bloco (1 a cada
+ * TRACK_LOD_STRIDE^L), mas sempre mantém as duas amostras de borda. Os vértices são gerados
+ * com as mesmas funções de generateTrackMesh (mesma perpendicular e mesma coordenada V),
+ * então o LOD 0 reproduz exatamente a malha completa e não há frestas entre blocos.
+ * @param centerPoints Linha central no plano XY do editor (como em generateTrackMesh).
+ * @param[out] track Blocos gerados (já no plano XZ), só em CPU: ChunkedTrack::upload cria os
+ * VAOs. Não chama OpenGL, então pode rodar fora da thread de renderização; os blocos antigos
+ * de `track` devem ter sido liberados (release) antes.
+ * @param cancel Se não nulo e marcado, os blocos restantes ficam vazios (quem cancelou os descarta).
+ */
+void buildTrackChunks(const std::vector<glm::vec3>& centerPoints, float trackWidth, float chunkLength,
+    ChunkedTrack& track, const std::atomic<bool>* cancel)
+{
+    track.chunks.clear();
+    const size_t n = centerPoints.size();
+    if (n < 2) return;
+    const float halfWidth = trackWidth * 0.5f;
+    const float uvScale = (trackWidth > 0.0f) ? 1.0f / trackWidth : 1.0f;
+
+    // Comprimento de arco acumulado em cada amostra (k == n é a costura que fecha a pista).
+    std::vector<float> distances(n + 1, 0.0f);
+    float distance = 0.0f;
+    for (size_t k = 1; k <= n; ++k) {
+        distance += glm::length(centerPoints[k % n] - centerPoints[k - 1]);
+        distances[k] = distance;
+    }
+
+    // Amostras de borda entre blocos consecutivos.
+    std::vector<size_t> borders{ 0 };
+    float nextBorder = chunkLength;
+    for (size_t k = 1; k < n; ++k) {
+        if (distances[k] >= nextBorder) {
+            borders.push_back(k);
+            nextBorder = distances[k] + chunkLength;
+        }
+    }
+    borders.push_back(n);
+
+    // Os blocos são independentes: cada um é uma tarefa do JobSystem, escrita no seu lugar.
+    track.chunks.resize(borders.size() - 1);
+    JobSystem::shared().parallelFor(track.chunks.size(), 1, [&](size_t begin, size_t end) {
+        std::vector<size_t>       samples;
+        std::vector<Vertex>       vertices;
+        std::vector<unsigned int> indices;
+        for (size_t c = begin; c < end; ++c) {
+            if (cancel && cancel->load(std::memory_order_relaxed)) return;
+            const size_t first = borders[c];
+            const size_t last = borders[c + 1];
+            TrackChunk& chunk = track.chunks[c];
+
+            size_t stride = 1;
+            for (int lod = 0; lod < TRACK_LOD_COUNT; ++lod, stride *= TRACK_LOD_STRIDE) {
+                samples.clear();
+                for (size_t k = first; k < last; k += stride)
+                    samples.push_back(k);
+                samples.push_back(last);
+
+                vertices.resize(2 * samples.size());
+                for (size_t j = 0; j < samples.size(); ++j)
+                    writeTrackSample(centerPoints, samples[j], halfWidth, distances[samples[j]] * uvScale, &vertices[2 * j]);
+                indices.resize(6 * (samples.size() - 1));
+                for (size_t j = 0; j + 1 < samples.size(); ++j)
+                    writeTrackQuad(j, &indices[6 * j]);
+                swapTrackYZ(vertices);
+
+                // A AABB do bloco vem do LOD completo (os LODs dizimados ficam contidos nela).
+                if (lod == 0) {
+                    chunk.boundsMin = chunk.boundsMax = glm::vec3(vertices[0].x, vertices[0].y, vertices[0].z);
+                    for (const auto& v : vertices) {
+                        chunk.boundsMin = glm::min(chunk.boundsMin, glm::vec3(v.x, v.y, v.z));
+                        chunk.boundsMax = glm::max(chunk.boundsMax, glm::vec3(v.x, v.y, v.z));
+                    }
+                }
+                chunk.lods[lod] = Mesh(vertices, indices, /*groupName=*/"track", /*mtlName=*/"", /*upload=*/false);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Corpo da thread de geração da pista: as etapas de TrackBuildStage, em ordem.
+ */
+void TrackBuildJob::run(std::vector<glm::vec3> controlPoints, float trackWidth, float chunkLength)
+{
+    const auto jobStart = std::chrono::steady_clock::now();
+    auto stageStart = jobStart;
+
+    // 1. Linha central: a curva B-Spline suave.
+    TrackPreview step;
+    step.centerLine = generateBSplinePoints(controlPoints, 50);
+    if (!finishStage(TRACK_STAGE_CENTERLINE, stageStart)) return;
+    publishPreview(step);
+
+    // 2. Malha grossa, só para a prévia: 1 a cada TRACK_PREVIEW_STRIDE amostras da linha central.
+    std::vector<glm::vec3> coarse;
+    for (size_t i = 0; i < step.centerLine.size(); i += TRACK_PREVIEW_STRIDE)
+        coarse.push_back(step.centerLine[i]);
+    generateTrackMesh(coarse, trackWidth, step.vertices, step.indices);
+    if (!finishStage(TRACK_STAGE_COARSE_MESH, stageStart)) return;
+    publishPreview(step);
+
+    // 3. Malha completa.
+    std::vector<Vertex>       vertices;
+    std::vector<unsigned int> indices;
+    generateTrackMeshParallel(step.centerLine, trackWidth, vertices, indices, 0, &cancelRequested);
+    if (!finishStage(TRACK_STAGE_FULL_MESH, stageStart)) return;
+    step.vertices = vertices;
+    step.indices = indices;
+    publishPreview(step);
+
+    // 4. Cena do visualizador.
+    // CRÍTICO: Transforma a pista do plano XY (editor) para o plano XZ (visualizador).
+    swapTrackYZ(vertices);
+    // Só a cópia em CPU: o VAO é criado pela thread de renderização.
+    Mesh trackMesh(vertices, indices, /*groupName=*/"track", /*mtlName=*/"", /*upload=*/false);
+    // Pontos da animação: reamostrados por comprimento de arco (mesma quantidade de pontos),
+    // assim cada passo da animação percorre a mesma distância e o carro não
+    // acelera/desacelera conforme a densidade da amostragem em t.
+    ArcLengthTable centerLine(controlPoints);
+    std::vector<glm::vec3> animationPoints = centerLine.sampleEvenly(step.centerLine.size());
+    if (cancelRequested) return;
+    GeneratedScene scene = prepareGeneratedScene(std::move(trackMesh), animationPoints, controlPoints,
+        step.centerLine, trackWidth, chunkLength, &cancelRequested);
+    if (!finishStage(TRACK_STAGE_SCENE, stageStart)) return;
+
+    std::cout << "Pista gerada em "
+        << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - jobStart).count() << " ms\n";
+    std::lock_guard<std::mutex> lock(mutex);
+    result = std::move(scene);
+    hasResult = true;
+}
+
+/**
+ * @brief Registra o fim de uma etapa: imprime sua duração e reinicia `stageStart`.
+ * @return false se a geração foi cancelada (a thread deve parar).
+ */
+bool TrackBuildJob::finishStage(TrackBuildStage stage, std::chrono::steady_clock::time_point& stageStart)
+{
+    if (cancelRequested) return false;
+    const auto now = std::chrono::steady_clock::now();
+    std::cout << "Pista [" << stage + 1 << '/' << TRACK_STAGE_COUNT << "] " << TRACK_STAGE_NAMES[stage] << ": "
+        << std::chrono::duration<double, std::milli>(now - stageStart).count() << " ms\n";
+    stageStart = now;
+    completedStages = stage + 1;
+    return true;
+}
+
+/**
+ * @brief Publica uma prévia, substituindo a anterior se a thread principal ainda não a retirou.
+ */
+void TrackBuildJob::publishPreview(const TrackPreview& step)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    preview = step;
+    hasPreview = true;
+}
+
+/**
+ * @brief Pose atual de um objeto animado, conforme o modo de animação ativo.
+ * @return false se o objeto não é animado (ou não tem amostras suficientes).
+ */
+static bool computeAnimatedPose(Object3D& obj, AnimatedPose& pose)
+{
+    if (obj.name != "Carro")
+        return false;
+    if (obj.animationStream && !obj.animationStream->empty()) {
+        obj.animationStream->sample(pose.position, pose.orientation);
+        return true;
+    }
+    if (obj.animationPath.empty())
+        return false;
+    if (constantSpeedAnimation) {
+        // Posição e orientação interpoladas na distância percorrida:
+        // consulta à tabela de referenciais + slerp entre as amostras vizinhas.
+        obj.animationPath.sample(obj.animationCursor, pose.position, pose.orientation);
+        return true;
+    }
+    if (obj.animationPositions.size() < 3)
+        return false;
+    // Modo por amostras: a orientação (base ortonormal alinhada à tangente) já foi
+    // pré-calculada na carga da animação, junto com animationPositions.
+    size_t idx = animationIndex % obj.animationPositions.size();
+    pose.position = obj.animationPositions[idx];
+    pose.orientation = obj.animationPath.frames[idx];
+    return true;
+}
+
+/**
+ * @brief Guarda no estado `state` o que a renderização interpola (câmera e poses animadas).
+ */
+static void captureSimulationState(SimulationState& state)
+{
+    state.cameraPos = globalConfig.cameraPos;
+    state.poses.clear();
+    for (auto& pair : meshes) {
+        AnimatedPose pose;
+        if (computeAnimatedPose(pair.second, pose))
+            state.poses[pair.first] = pose;
+    }
+}
+
+/**
+ * @brief Avança a simulação em `dt` segundos (sempre SIMULATION_STEP no loop principal).
+ * @details Todo movimento é proporcional a `dt`: a câmera anda `cameraSpeed` unidades por
+ * segundo e as animações avançam `animationSpeed * dt`. O estado resultante vira o atual
+ * e o anterior é mantido para a interpolação da renderização.
+ */
+void simulationStep(float dt)
+{
+    // Movimentação da câmera baseada nas flags de input.
+    const glm::vec3 right = glm::normalize(glm::cross(globalConfig.cameraFront, cameraUp));
+    const float step = globalConfig.cameraSpeed * dt;
+    if (moveW)
+        globalConfig.cameraPos += globalConfig.cameraFront * step;
+    if (moveA)
+        globalConfig.cameraPos -= right * step;
+    if (moveS)
+        globalConfig.cameraPos -= globalConfig.cameraFront * step;
+    if (moveD)
+        globalConfig.cameraPos += right * step;
+
+    // Animação com velocidade constante: cada objeto avança velocidade * dt ao longo da trajetória.
+    // O cursor lembra o segmento atual, então o custo por objeto é O(1) amortizado.
+    // Gravações em streaming sempre usam esse modo (não há amostras carregadas para o modo antigo).
+    for (auto& pair : meshes) {
+        Object3D& obj = pair.second;
+        if (obj.animationStream)
+            obj.animationStream->advance(obj.animationSpeed * dt);
+        else if (constantSpeedAnimation && !obj.animationPath.empty())
+            obj.animationPath.advance(obj.animationCursor, obj.animationSpeed * dt);
+    }
+
+    // Atualiza a animação do carro (modo por amostras) usando o acumulador de tempo.
+    animAccumulator += dt;
+    auto car = meshes.find("Carro");
+    if (car != meshes.end() && !car->second.animationPositions.empty()) {
+        while (animAccumulator >= STEP_TIME) {
+            animationIndex = (animationIndex + 1) % car->second.animationPositions.size();
+            animAccumulator -= STEP_TIME;
+        }
+    }
+    else {
+        animAccumulator = 0.0f;
+    }
+
+    currentSim = 1 - currentSim;
+    captureSimulationState(simStates[currentSim]);
+}
+
+/**
+ * @brief Descarta o histórico da simulação: os dois estados passam a ser o estado atual.
+ * @details Chamado quando a cena é (re)carregada, para não interpolar com poses de outra cena.
+ */
+void resetSimulation()
+{
+    captureSimulationState(simStates[currentSim]);
+    simStates[1 - currentSim] = simStates[currentSim];
+    simAccumulator = 0.0f;
+}
+
+/**
+ * @brief Exporta os pontos de animação (a linha central da pista) para um arquivo.
+ * @details Realiza a importante troca de coordenadas Y e Z para alinhar com o
+ * sistema de coordenadas do visualizador 3D, onde Y é a altura.
+ * O formato é escolhido pela extensão: `.anim` grava o formato binário quantizado
+ * (com diferenças e orientações pré-calculadas); qualquer outra grava texto, uma linha por ponto.
+ */
+// Requisito 2i: Exportação dos pontos de animação
+void exportAnimationPoints(const std::vector<glm::vec3>& points, const std::string& filename) {
+    if (isBinaryAnimationFile(filename)) {
+        std::vector<glm::vec3> swapped;
+        swapped.reserve(points.size());
+        for (const auto& p : points)
+            swapped.emplace_back(p.x, p.z, p.y); // Mesma troca Y↔Z do formato texto.
+        AnimationPath path(swapped);
+        writeAnimationFile(filename, swapped, path.empty() ? nullptr : &path.frames, /*deltaEncode=*/true);
+        return;
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Falha ao criar " << filename << '\n';
+        return;
+    }
+
+    for (const auto& p : points) {
+        // O editor cria a pista no plano XY (p.x, p.y), com a altura em p.z.
+        // O visualizador espera a pista no plano XZ, com a altura em Y.
+        // Portanto, gravamos: X=p.x, Y=p.z (altura), Z=p.y.
         // Troca Y↔Z para alinhar com o chão XZ, mas grava p.z como altura
         file << p.x << ' '    // X
             << p.z << ' '    // Y = interpolação de altura
@@ -933,6 +2900,7 @@ void exportAnimationPoints(const std::vector<glm::vec3>& points, const std::stri
 /**
  * @brief Gera o arquivo de cena (.txt) que descreve toda a cena para o visualizador,
  * incluindo objetos, materiais, configurações globais e curvas de debug.
+ * @param controlPoints Pontos de controle do editor, com a altura (yl) em Z.
  */
 // Requisito 2j: Geração do arquivo de cena
 void generateSceneFile(const std::string& trackObj, const std::string& carObj, const std::string& animFile,
@@ -940,22 +2908,24 @@ void generateSceneFile(const std::string& trackObj, const std::string& carObj, c
 {
     std::ofstream file(sceneFile);
     // Escreve o bloco de configurações globais.
+    GlobalConfig config{};
+    applyGeneratedSceneConfig(config);
     file << "Type GlobalConfig Config\n"
-        << "LightPos 2.0 10.0 2.0\n"
-        << "LightColor 1.0 1.0 1.0\n"
-        << "CameraPos 0.0 5.0 10.0\n"
-        << "CameraFront 0.0 0.0 -1.0\n"
-        << "Fov 45.0\n"
-        << "NearPlane 0.1\n"
-        << "FarPlane 100.0\n"
-        << "Sensitivity 0.1\n"
-        << "CameraSpeed 0.008\n"
-        << "AttConstant 0.2\n"
-        << "AttLinear 0.02\n"
-        << "AttQuadratic 0.005\n"
-        << "FogColor 0.5 0.5 0.5\n"
-        << "FogStart 5.0\n"
-        << "FogEnd 50.0\n"
+        << "LightPos " << config.lightPos.x << ' ' << config.lightPos.y << ' ' << config.lightPos.z << "\n"
+        << "LightColor " << config.lightColor.r << ' ' << config.lightColor.g << ' ' << config.lightColor.b << "\n"
+        << "CameraPos " << config.cameraPos.x << ' ' << config.cameraPos.y << ' ' << config.cameraPos.z << "\n"
+        << "CameraFront " << config.cameraFront.x << ' ' << config.cameraFront.y << ' ' << config.cameraFront.z << "\n"
+        << "Fov " << config.fov << "\n"
+        << "NearPlane " << config.nearPlane << "\n"
+        << "FarPlane " << config.farPlane << "\n"
+        << "Sensitivity " << config.sensitivity << "\n"
+        << "CameraSpeed " << config.cameraSpeed << "\n"
+        << "AttConstant " << config.attConstant << "\n"
+        << "AttLinear " << config.attLinear << "\n"
+        << "AttQuadratic " << config.attQuadratic << "\n"
+        << "FogColor " << config.fogColor.r << ' ' << config.fogColor.g << ' ' << config.fogColor.b << "\n"
+        << "FogStart " << config.fogStart << "\n"
+        << "FogEnd " << config.fogEnd << "\n"
         << "End\n";
     // Escreve a definição do objeto Pista.
     file << "Type Mesh Track\n"
@@ -977,26 +2947,134 @@ void generateSceneFile(const std::string& trackObj, const std::string& carObj, c
         << "Angle 0.0 0.0 0.0\n"
         << "IncrementalAngle 0\n"
         << "AnimationFile " << animFile << "\n"
+        << "AnimationSpeed 2.0\n"
         << "End\n";
     // Escreve a definição da curva B-Spline para visualização de debug.
     file << "Type BSplineCurve Curve1\n";
-    for (size_t i = 0; i < controlPoints.size(); ++i) {
-        const auto& cp = controlPoints[i];
-        // use the stored yellow‐level as height
-        float yl = (i < editorPointYellowLevels.size())
-            ? editorPointYellowLevels[i]
-            : 0.0f;
+    for (const auto& cp : controlPoints) {
         // Salva os pontos de controle com sua altura (yl) na coordenada Z para a curva.
         file << "ControlPoint "
             << cp.x << " "
             << cp.y << " "
-            << yl << "\n";
+            << cp.z << "\n";
     }
     file << "PointsPerSegment 100\n"
         << "Color 1.0 0.0 0.0 1.0\n"
         << "End\n";
     file.close();
 }
+
+/**
+ * @brief Preenche a configuração global usada pelas cenas geradas no editor.
+ * @details Fonte única dos valores gravados por generateSceneFile e aplicados diretamente
+ * por loadGeneratedScene.
+ */
+void applyGeneratedSceneConfig(GlobalConfig& config)
+{
+    config.lightPos = glm::vec3(2.0f, 10.0f, 2.0f);
+    config.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    config.cameraPos = glm::vec3(0.0f, 5.0f, 10.0f);
+    config.cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+    config.fov = 45.0f;
+    config.nearPlane = 0.1f;
+    config.farPlane = 100.0f;
+    config.sensitivity = 0.1f;
+    config.cameraSpeed = 0.5f;
+    config.attConstant = 0.2f;
+    config.attLinear = 0.02f;
+    config.attQuadratic = 0.005f;
+    config.fogColor = glm::vec3(0.5f, 0.5f, 0.5f);
+    config.fogStart = 5.0f;
+    config.fogEnd = 50.0f;
+}
+
+/**
+ * @brief Monta, só em CPU, a cena do visualizador diretamente a partir dos dados gerados no editor.
+ * @details Equivale a gravar track.obj, animation.anim e Scene.txt e relê-los com
+ * readSceneFile, sem a ida e volta ao disco: a malha da pista é movida para o objeto, os
+ * pontos de animação e a curva vêm da memória (sem a quantização do `.anim`). Não usa
+ * OpenGL nem as variáveis globais da cena, então pode rodar em qualquer thread; a cena é
+ * enviada à GPU e publicada por installGeneratedScene.
+ * @param trackMesh Malha da pista (plano XZ), montada sem VAO.
+ * @param animationPoints Pontos da animação no plano do editor (como em exportAnimationPoints).
+ * @param controlPoints Pontos de controle do editor, com a altura em Z.
+ * @param curvePoints Linha central da pista (como em buildTrackChunks).
+ * @param cancel Repassado a buildTrackChunks.
+ */
+GeneratedScene prepareGeneratedScene(Mesh&& trackMesh, const std::vector<glm::vec3>& animationPoints,
+    const std::vector<glm::vec3>& controlPoints, const std::vector<glm::vec3>& curvePoints,
+    float trackWidth, float chunkLength, const std::atomic<bool>* cancel)
+{
+    // Mesmos objetos e parâmetros que generateSceneFile grava em Scene.txt.
+    Object3D track("Track", std::move(trackMesh), "track.mtl",
+        glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f), 0, /*upload=*/false);
+    track.drawsTrackChunks = true; // Os blocos (scene.chunks) são gerados da mesma linha central.
+    // O modelo do carro não é gerado: continua vindo do disco.
+    Object3D car("Carro", "car.obj", "car.mtl",
+        glm::vec3(0.5f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f), 0, /*upload=*/false);
+    car.animationPositions.reserve(animationPoints.size());
+    for (const auto& p : animationPoints)
+        car.animationPositions.emplace_back(p.x, p.z, p.y); // Mesma troca Y↔Z de exportAnimationPoints.
+    car.animationPath = AnimationPath(car.animationPositions);
+    car.animationSpeed = 2.0f;
+
+    BSplineCurve curve = buildBSplineCurve(controlPoints, 100);
+    curve.name = "Curve1";
+    curve.color = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+
+    GeneratedScene scene;
+    // Divide a pista em blocos com LODs; o visualizador desenha os blocos no lugar da malha única.
+    buildTrackChunks(curvePoints, trackWidth, chunkLength, scene.chunks, cancel);
+    scene.track = std::move(track);
+    scene.car = std::move(car);
+    scene.curve = std::move(curve);
+    scene.animationPoints = animationPoints;
+    scene.controlPoints = controlPoints;
+    return scene;
+}
+
+/**
+ * @brief Envia a cena gerada à GPU e a publica no modo visualizador (thread principal).
+ */
+void installGeneratedScene(GeneratedScene& scene)
+{
+    // Só o envio à GPU roda na thread de renderização; esta thread espera sem tocar na cena.
+    if (!runOnRenderThread([&] {
+            scene.track.upload();
+            scene.car.upload();
+            uploadBSplineCurve(scene.curve);
+            trackChunks.release();
+            trackChunks = std::move(scene.chunks);
+            trackChunks.upload();
+        }))
+        return;
+
+    applyGeneratedSceneConfig(globalConfig);
+    meshes.insert({ scene.track.name, std::move(scene.track) });
+    meshList.push_back("Track");
+    meshes.insert({ scene.car.name, std::move(scene.car) });
+    meshList.push_back("Carro");
+    bSplineCurves.insert(std::make_pair(scene.curve.name, std::move(scene.curve)));
+}
+
+/**
+ * @brief Grava a cena gerada (track.obj, animation.anim e Scene.txt) em segundo plano.
+ * @details Recebe cópias, então a cena em uso não é compartilhada com a gravação. Uma nova
+ * gravação espera a anterior, pois escrevem os mesmos arquivos.
+ */
+void saveGeneratedSceneAsync(const Mesh& trackMesh, const std::vector<glm::vec3>& animationPoints,
+    const std::vector<glm::vec3>& controlPoints)
+{
+    if (pendingSave.valid())
+        pendingSave.wait();
+    pendingSave = std::async(std::launch::async,
+        [mesh = trackMesh, animationPoints, controlPoints] {
+            OBJWriter objWriter;
+            objWriter.write(mesh, "track.obj");
+            exportAnimationPoints(animationPoints, "animation.anim");
+            generateSceneFile("track.obj", "car.obj", "animation.anim", "Scene.txt", controlPoints);
+        });
+}
 // ============================================================================
 // ============================================================================
 // ============================================================================
@@ -1004,42 +3082,36 @@ void generateSceneFile(const std::string& trackObj, const std::string& carObj, c
 
 
 /**
- * @brief Lê o arquivo de cena (.txt) e popula todas as estruturas de dados da aplicação
- * (configurações globais, objetos, curvas). Este é o parser que prepara o modo visualizador.
+ * @brief Lê o arquivo de cena (.txt) sem carregar nenhum recurso: só a descrição dos objetos.
+ * @param[in,out] scene `scene.config` deve vir com os valores atuais/padrão: o arquivo só
+ * sobrescreve as chaves que contém. Os objetos lidos são acrescentados a `scene.objects`.
+ * @return false se o arquivo não pôde ser aberto.
  */
-// Requisito 3: Leitura do arquivo de cena e pontos de animação
-void readSceneFile(const std::string& sceneFilePath,
-    std::unordered_map<std::string, Object3D>* meshes,
-    std::vector<std::string>* meshList,
-    std::unordered_map<std::string, BSplineCurve>* bSplineCurves,
-    GlobalConfig* globalConfig)
+bool parseSceneFile(const std::string& sceneFilePath, SceneDesc& scene)
 {
     std::ifstream file(sceneFilePath);
     std::string line;
     if (!file.is_open())
     {
         std::cerr << "Falha ao abrir o arquivo " << sceneFilePath << std::endl;
-        return;
+        return false;
     }
 
-    // Variáveis temporárias para armazenar os dados de um objeto enquanto ele está sendo lido.
-    std::string objectType, name, objFilePath, mtlFilePath, animFile;
-    glm::vec3 scale{ 1.0f }, position{ 0.0f }, rotation{ 0.0f }, angle{ 0.0f };
-    GLuint incrementalAngle = false;
-    std::vector<glm::vec3> tempControlPoints;
-    GLuint pointsPerSegment = 0;
-    glm::vec4 color{ 1.0f };
+    GlobalConfig* globalConfig = &scene.config;
+    // Objeto sendo lido; cada bloco "Type" começa com os valores padrão.
+    SceneObjectDesc desc;
 
     // Lê o arquivo linha por linha.
     while (getline(file, line))
     {
-        std::istringstream ss(line);
-        std::string type;
-        ss >> type; // O primeiro token da linha define o tipo de dado.
+        LineScanner ss(line);
+        const std::string_view type = ss.token(); // O primeiro token da linha define o tipo de dado.
 
-        // Bloco `if-else` gigante para parsear cada tipo de linha e preencher as variáveis temporárias.
-        if (type == "Type")
-            ss >> objectType >> name;
+        // Bloco `if-else` gigante para parsear cada tipo de linha e preencher o objeto atual.
+        if (type == "Type") {
+            desc = SceneObjectDesc();
+            ss >> desc.type >> desc.name;
+        }
         else if (type == "LightPos")
             ss >> globalConfig->lightPos.x >> globalConfig->lightPos.y >> globalConfig->lightPos.z;
         else if (type == "LightColor")
@@ -1071,88 +3143,794 @@ void readSceneFile(const std::string& sceneFilePath,
         else if (type == "FogEnd")
             ss >> globalConfig->fogEnd;
         else if (type == "Obj")
-            ss >> objFilePath;
+            ss >> desc.objFile;
         else if (type == "Mtl")
-            ss >> mtlFilePath;
+            ss >> desc.mtlFile;
         else if (type == "Scale")
-            ss >> scale.x >> scale.y >> scale.z;
+            ss >> desc.scale.x >> desc.scale.y >> desc.scale.z;
         else if (type == "Position")
-            ss >> position.x >> position.y >> position.z;
+            ss >> desc.position.x >> desc.position.y >> desc.position.z;
         else if (type == "Rotation")
-            ss >> rotation.x >> rotation.y >> rotation.z;
+            ss >> desc.rotation.x >> desc.rotation.y >> desc.rotation.z;
         else if (type == "Angle")
-            ss >> angle.x >> angle.y >> angle.z;
+            ss >> desc.angle.x >> desc.angle.y >> desc.angle.z;
         else if (type == "IncrementalAngle")
-            ss >> incrementalAngle;
+            ss >> desc.incrementalAngle;
         else if (type == "AnimationFile")
-            ss >> animFile;
+            ss >> desc.animFile;
+        else if (type == "AnimationSpeed")
+            ss >> desc.animationSpeed;
         else if (type == "ControlPoint")
         {
             glm::vec3 cp;
             ss >> cp.x >> cp.y >> cp.z;
-            tempControlPoints.push_back(cp);
+            desc.controlPoints.push_back(cp);
         }
         else if (type == "PointsPerSegment")
-            ss >> pointsPerSegment;
+            ss >> desc.pointsPerSegment;
         else if (type == "Color")
-            ss >> color.r >> color.g >> color.b >> color.a;
-        else if (type == "End") // A diretiva "End" finaliza o objeto atual e o constrói.
+            ss >> desc.color.r >> desc.color.g >> desc.color.b >> desc.color.a;
+        else if (type == "End") // A diretiva "End" finaliza o objeto atual.
         {
-            if (objectType == "GlobalConfig")
-            {
-                // Os dados já foram preenchidos diretamente na struct globalConfig.
+            // Os dados de "GlobalConfig" já foram preenchidos diretamente em scene.config.
+            if (desc.type == "Mesh" || desc.type == "BSplineCurve")
+                scene.objects.push_back(desc);
+        }
+    }
+    file.close();
+    return true;
+}
+
+/**
+ * @brief Usa uma gravação `.anim` já aberta como a animação do objeto.
+ * @details Gravações muito longas não são carregadas: são reproduzidas em streaming.
+ */
+static void attachAnimation(Object3D& obj, AnimationFile&& anim)
+{
+    std::vector<glm::quat> frames;
+    if (anim.sampleCount() > ANIM_STREAM_THRESHOLD)
+        obj.animationStream = std::make_shared<AnimationStream>(std::move(anim));
+    else
+        anim.readAll(obj.animationPositions, &frames);
+    obj.animationPath = AnimationPath(obj.animationPositions, frames);
+}
+
+/**
+ * @brief Carrega a animação de um objeto a partir de um arquivo `.anim` (binário) ou de texto.
+ * @details Substitui a animação anterior do objeto, se houver, e reinicia o cursor.
+ */
+void loadAnimation(Object3D& obj, const std::string& animFile, float animationSpeed)
+{
+    obj.animationPositions.clear();
+    obj.animationStream.reset();
+    obj.animationPath = AnimationPath();
+    obj.animationCursor = AnimationCursor();
+    obj.animationSpeed = animationSpeed;
+
+    if (!animFile.empty() && isBinaryAnimationFile(animFile)) {
+        // Formato binário: mapeia o arquivo e decodifica posições e orientações.
+        AnimationFile anim;
+        if (anim.open(animFile))
+            attachAnimation(obj, std::move(anim));
+        else
+            std::cerr << "Falha ao abrir " << animFile << '\n';
+    }
+    else if (!animFile.empty()) {
+        std::ifstream anim(animFile);
+        std::string animLine;
+        while (std::getline(anim, animLine)) {
+            LineScanner ass(animLine);
+            glm::vec3 pos;
+            ass >> pos.x >> pos.y >> pos.z;
+            obj.animationPositions.push_back(pos);
+        }
+        anim.close();
+
+        // Tabela de comprimento de arco para a animação com velocidade constante.
+        obj.animationPath = AnimationPath(obj.animationPositions);
+    }
+}
+
+/**
+ * @brief Cria o Object3D descrito por um bloco "Type Mesh" da cena.
+ * @param upload Se false, só lê os arquivos (malha em CPU, sem textura): pode rodar fora da
+ * thread de renderização; Object3D::upload completa o objeto depois.
+ */
+Object3D loadSceneObject(const SceneObjectDesc& desc, bool upload)
+{
+    // Cria o Object3D. O construtor do Object3D irá, por sua vez,
+    // parsear os arquivos .obj e .mtl especificados.
+    Object3D obj(
+        /*_name=*/           desc.name,
+        /*_objPath=*/        desc.objFile,
+        /*_mtlPath=*/        desc.mtlFile,
+        /*scale_=*/          desc.scale,
+        /*pos_=*/            desc.position,
+        /*rot_=*/            desc.rotation,
+        /*ang_=*/            desc.angle,
+        /*incAng=*/          desc.incrementalAngle,
+        /*upload_=*/         upload
+    );
+
+    // Se houver um arquivo de animação, lê os pontos e os armazena no objeto.
+    if (!desc.animFile.empty())
+        loadAnimation(obj, desc.animFile, desc.animationSpeed);
+    return obj;
+}
+
+/**
+ * @brief Carrega, em paralelo e só em CPU, os objetos "Mesh" de uma cena (na mesma ordem).
+ * @details Os objetos não dependem uns dos outros: cada um (.obj, .mtl, decodificação da
+ * textura e animação) é uma tarefa do JobSystem::shared(), então o tempo de carga tende ao do
+ * maior objeto, e não à soma de todos. O envio à GPU fica para o chamador, em lote, na thread
+ * dona do contexto (Object3D::upload).
+ */
+std::vector<Object3D> loadSceneObjects(const std::vector<SceneObjectDesc>& descs)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t allocationsBefore = heapAllocations.load(std::memory_order_relaxed);
+    JobSystem& jobs = JobSystem::shared();
+    std::vector<Object3D> objects(descs.size());
+    // Uma tarefa por objeto: os de custo desigual se equilibram pelo roubo de trabalho.
+    jobs.parallelFor(descs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            objects[i] = loadSceneObject(descs[i], /*upload=*/false);
+    });
+
+    if (!descs.empty()) {
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << descs.size() << " objetos lidos em " << ms << " ms ("
+            << std::min<size_t>(jobs.threadCount(), descs.size()) << " threads): "
+            << heapAllocations.load(std::memory_order_relaxed) - allocationsBefore << " alocacoes no heap, pico de RSS "
+            << peakResidentBytes() / (1024 * 1024) << " MB\n";
+    }
+    return objects;
+}
+
+/**
+ * @brief Lê o arquivo de cena (.txt) e popula todas as estruturas de dados da aplicação
+ * (configurações globais, objetos, curvas). Este é o parser que prepara o modo visualizador.
+ * @details Cria VAOs e texturas: deve ser chamada na thread dona do contexto OpenGL.
+ */
+// Requisito 3: Leitura do arquivo de cena e pontos de animação
+void readSceneFile(const std::string& sceneFilePath,
+    std::unordered_map<std::string, Object3D>* meshes,
+    std::vector<std::string>* meshList,
+    std::unordered_map<std::string, BSplineCurve>* bSplineCurves,
+    GlobalConfig* globalConfig)
+{
+    PROFILE_ZONE("readSceneFile");
+    SceneDesc scene;
+    scene.config = *globalConfig;
+    if (!parseSceneFile(sceneFilePath, scene))
+        return;
+    *globalConfig = scene.config;
+
+    // Os arquivos de todos os objetos são lidos em paralelo; os envios à GPU vêm depois, nesta thread.
+    std::vector<SceneObjectDesc> meshDescs;
+    for (const SceneObjectDesc& desc : scene.objects)
+        if (desc.type == "Mesh") meshDescs.push_back(desc);
+    std::vector<Object3D> objects = loadSceneObjects(meshDescs);
+    for (Object3D& obj : objects) {
+        // Insere o objeto totalmente carregado no mapa global.
+        obj.upload();
+        meshList->push_back(obj.name);
+        meshes->insert({ obj.name, std::move(obj) });
+    }
+
+    for (const SceneObjectDesc& desc : scene.objects) {
+        if (desc.type == "BSplineCurve") {
+            // Cria a estrutura BSplineCurve com os dados lidos e a insere no mapa.
+            BSplineCurve bc = createBSplineCurve(desc.controlPoints, desc.pointsPerSegment);
+            bc.name = desc.name;
+            bc.color = desc.color;
+            bSplineCurves->insert(std::make_pair(desc.name, bc));
+        }
+    }
+}
+
+// ============================================================================
+// RECARGA DA CENA (HOT RELOAD)
+// ============================================================================
+
+/**
+ * @brief Passa a observar `path` e os arquivos que a cena usa (.obj, .mtl, texturas, animações).
+ * @param scene Descrição da cena já carregada (referência para os próximos diffs).
+ */
+void watchScene(const std::string& path, SceneDesc scene)
+{
+    liveScenePath = path;
+    liveScene = std::move(scene);
+
+    std::vector<std::string> files{ liveScenePath };
+    for (const SceneObjectDesc& desc : liveScene.objects) {
+        if (desc.type != "Mesh") continue;
+        files.push_back(desc.objFile);
+        files.push_back(desc.mtlFile);
+        files.push_back(desc.animFile);
+        auto live = meshes.find(desc.name);
+        if (live != meshes.end())
+            files.push_back(live->second.material.textureName);
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    // Reiniciar a observação descartaria mudanças ainda não relatadas de outros arquivos.
+    if (files != watchedFiles) {
+        watchedFiles = files;
+        sceneWatcher.watch(watchedFiles);
+    }
+}
+
+/**
+ * @brief Carrega um arquivo de cena direto no modo visualizador (opção `--scene`) e passa a observá-lo.
+ * @details Os arquivos são lidos nesta thread; a de renderização só envia os buffers à GPU.
+ * Aceita também um pacote de cena (.pack, ver compileScenePack), que não é observado: é um
+ * artefato compilado, refeito a partir do arquivo de cena.
+ */
+void loadSceneIntoViewer(const std::string& path)
+{
+    SceneDesc scene;
+    scene.config = globalConfig;
+    std::vector<Object3D> objects;
+    const bool packed = isScenePackFile(path);
+    if (packed) {
+        if (!loadScenePack(path, scene, objects))
+            return;
+    }
+    else {
+        if (!parseSceneFile(path, scene))
+            return;
+        std::vector<SceneObjectDesc> meshDescs;
+        for (const SceneObjectDesc& desc : scene.objects)
+            if (desc.type == "Mesh") meshDescs.push_back(desc);
+        objects = loadSceneObjects(meshDescs);
+    }
+
+    std::vector<BSplineCurve> curves;
+    for (const SceneObjectDesc& desc : scene.objects) {
+        if (desc.type == "BSplineCurve") {
+            curves.push_back(buildBSplineCurve(desc.controlPoints, desc.pointsPerSegment));
+            curves.back().name = desc.name;
+            curves.back().color = desc.color;
+        }
+    }
+    if (!runOnRenderThread([&] {
+            for (auto& obj : objects) obj.upload();
+            for (auto& curve : curves) uploadBSplineCurve(curve);
+        }))
+        return;
+
+    globalConfig = scene.config;
+    for (auto& obj : objects) {
+        meshList.push_back(obj.name);
+        meshes.insert({ obj.name, std::move(obj) });
+    }
+    for (auto& curve : curves)
+        bSplineCurves.insert(std::make_pair(curve.name, std::move(curve)));
+    editorMode = false;
+    if (!packed)
+        watchScene(path, std::move(scene));
+}
+
+/**
+ * @brief Libera um objeto da cena depois que os frames que ainda o desenham forem descartados.
+ * @details Os comandos vão no próximo FramePacket, que já não referencia o objeto.
+ */
+static void retireObject(const Object3D& obj)
+{
+    const GLuint VAO = obj.mesh.VAO;
+    const GLuint textureID = obj.textureID;
+    pendingReleases.push_back([VAO, textureID] {
+        deleteVertexArrayAndBuffers(VAO);
+        if (textureID) glDeleteTextures(1, &textureID);
+    });
+}
+
+template <typename T>
+static bool applyIfChanged(T GlobalConfig::* field, const GlobalConfig& before, const GlobalConfig& after)
+{
+    if (before.*field == after.*field) return false;
+    globalConfig.*field = after.*field;
+    return true;
+}
+
+/**
+ * @brief Aplica à cena em uso as diferenças entre `liveScene` e `next`, comparando os objetos pelo nome.
+ * @param changedFiles Arquivos modificados em disco desde a última recarga.
+ * @details Só é relido o que mudou: um objeto com outro .obj (ou com o .obj modificado) é
+ * recarregado inteiro; um .mtl ou textura modificados recarregam só o material; uma animação
+ * modificada recarrega só a animação. Transformações e configurações globais são aplicadas no
+ * lugar, sem tocar nos buffers da GPU. Da configuração global, só os campos que mudaram no
+ * arquivo são aplicados (a câmera movida pelo usuário fica onde está).
+ */
+void applySceneReload(const SceneDesc& next, const std::unordered_set<std::string>& changedFiles)
+{
+    const GlobalConfig& before = liveScene.config;
+    const GlobalConfig& after = next.config;
+    int configChanges = 0;
+    configChanges += applyIfChanged(&GlobalConfig::lightPos, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::lightColor, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::cameraPos, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::cameraFront, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::fov, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::nearPlane, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::farPlane, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::sensitivity, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::cameraSpeed, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::attConstant, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::attLinear, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::attQuadratic, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::fogColor, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::fogStart, before, after);
+    configChanges += applyIfChanged(&GlobalConfig::fogEnd, before, after);
+
+    auto fileChanged = [&](const std::string& path) { return !path.empty() && changedFiles.count(path) > 0; };
+    std::unordered_map<std::string, const SceneObjectDesc*> previous;
+    for (const SceneObjectDesc& desc : liveScene.objects)
+        previous[desc.name] = &desc;
+
+    std::vector<SceneObjectDesc> reloadDescs; // Objetos novos ou com outra geometria.
+    std::vector<Object3D*>    patched;    // Objetos em uso com material novo a enviar.
+    std::vector<BSplineCurve> curves;     // Curvas novas ou com outros pontos.
+    std::unordered_set<std::string> present;
+    int updated = 0;
+    bool animationsChanged = false;
+
+    for (const SceneObjectDesc& desc : next.objects) {
+        present.insert(desc.name);
+        auto it = previous.find(desc.name);
+        const SceneObjectDesc* old = (it != previous.end() && it->second->type == desc.type) ? it->second : nullptr;
+
+        if (desc.type == "BSplineCurve") {
+            auto live = bSplineCurves.find(desc.name);
+            if (!old || live == bSplineCurves.end() || old->controlPoints != desc.controlPoints
+                || old->pointsPerSegment != desc.pointsPerSegment) {
+                curves.push_back(buildBSplineCurve(desc.controlPoints, desc.pointsPerSegment));
+                curves.back().name = desc.name;
+                curves.back().color = desc.color;
             }
-            else if (objectType == "Mesh")
-            {
-                // Cria o Object3D. O construtor do Object3D irá, por sua vez,
-                // parsear os arquivos .obj e .mtl especificados.
-                Object3D obj(
-                    /*_name=*/           name,
-                    /*_objPath=*/        objFilePath,
-                    /*_mtlPath=*/        mtlFilePath,
-                    /*scale_=*/          scale,
-                    /*pos_=*/            position,
-                    /*rot_=*/            rotation,
-                    /*ang_=*/            angle,
-                    /*incAng=*/          incrementalAngle
-                );
-
-                // Se houver um arquivo de animação, lê os pontos e os armazena no objeto.
-                if (!animFile.empty()) {
-                    std::ifstream anim(animFile);
-                    std::string animLine;
-                    while (std::getline(anim, animLine)) {
-                        std::istringstream ass(animLine);
-                        glm::vec3 pos;
-                        ass >> pos.x >> pos.y >> pos.z;
-                        obj.animationPositions.push_back(pos);
-                    }
-                    anim.close();
-                }
+            else if (old->color != desc.color) {
+                live->second.color = desc.color;
+                ++updated;
+            }
+            continue;
+        }
+
+        auto live = meshes.find(desc.name);
+        if (!old || live == meshes.end() || old->objFile != desc.objFile || fileChanged(desc.objFile)) {
+            reloadDescs.push_back(desc);
+            animationsChanged = animationsChanged || !desc.animFile.empty();
+            continue;
+        }
 
-                // Insere o objeto totalmente carregado no mapa global.
-                meshes->insert({ name, obj });
-                meshList->push_back(name);
+        Object3D& obj = live->second;
+        bool changed = false;
+        if (old->mtlFile != desc.mtlFile || fileChanged(desc.mtlFile) || fileChanged(obj.material.textureName)) {
+            Material material = setupMtl(desc.mtlFile);
+            if (material.textureName != obj.material.textureName || fileChanged(material.textureName)) {
+                // A textura antiga só é apagada depois que os frames que a usam saírem da fila.
+                const GLuint oldTexture = obj.textureID;
+                if (oldTexture)
+                    pendingReleases.push_back([oldTexture] { glDeleteTextures(1, &oldTexture); });
+                obj.textureID = 0;
+                patched.push_back(&obj);
             }
-            else if (objectType == "BSplineCurve")
-            {
-                // Cria a estrutura BSplineCurve com os dados lidos e a insere no mapa.
-                BSplineCurve bc = createBSplineCurve(tempControlPoints, pointsPerSegment);
-                bc.name = name;
-                bc.controlPoints = tempControlPoints;
-                bc.color = color;
-                bc.pointsPerSegment = pointsPerSegment;
-                bc.controlPointsVAO = generateControlPointsBuffer(tempControlPoints);
-                bSplineCurves->insert(std::make_pair(name, bc));
-                tempControlPoints.clear(); // Limpa para o próximo objeto do tipo curva.
+            obj.mtlFilePath = desc.mtlFile;
+            obj.material = material;
+            if (obj.textureID == 0 && !material.textureName.empty())
+                obj.textureImage = decodeTexture(material.textureName);
+            changed = true;
+        }
+        if (old->animFile != desc.animFile || old->animationSpeed != desc.animationSpeed || fileChanged(desc.animFile)) {
+            if (old->animFile != desc.animFile || fileChanged(desc.animFile))
+                loadAnimation(obj, desc.animFile, desc.animationSpeed);
+            else
+                obj.animationSpeed = desc.animationSpeed;
+            animationsChanged = true;
+            changed = true;
+        }
+        if (old->scale != desc.scale || old->position != desc.position || old->rotation != desc.rotation
+            || old->angle != desc.angle || old->incrementalAngle != desc.incrementalAngle) {
+            // Transformação: só muda a matriz de modelo, montada a cada frame.
+            obj.scale = desc.scale;
+            obj.position = desc.position;
+            obj.rotation = desc.rotation;
+            obj.angle = desc.angle;
+            obj.incrementalAngle = desc.incrementalAngle;
+            changed = true;
+        }
+        updated += changed;
+    }
+
+    // Leitura (em paralelo) e envio à GPU do que foi (re)carregado; esta thread espera sem tocar na cena.
+    std::vector<Object3D> reloaded = loadSceneObjects(reloadDescs);
+    if (!reloaded.empty() || !patched.empty() || !curves.empty()) {
+        if (!runOnRenderThread([&] {
+                for (auto& obj : reloaded) obj.upload();
+                for (auto* obj : patched) obj->upload();
+                for (auto& curve : curves) uploadBSplineCurve(curve);
+            }))
+            return;
+    }
+
+    for (auto& obj : reloaded) {
+        auto live = meshes.find(obj.name);
+        if (live != meshes.end()) {
+            // A pista em blocos foi gerada a partir da malha antiga: passa a desenhar a malha lida.
+            if (live->second.drawsTrackChunks)
+                pendingReleases.push_back([] { trackChunks.release(); });
+            retireObject(live->second);
+            live->second = std::move(obj);
+        }
+        else {
+            meshList.push_back(obj.name);
+            meshes.insert({ obj.name, std::move(obj) });
+        }
+    }
+    for (auto& curve : curves) {
+        auto live = bSplineCurves.find(curve.name);
+        if (live != bSplineCurves.end()) {
+            const GLuint VAO = live->second.VAO; // O VAO dos pontos de controle é o do editor (compartilhado).
+            pendingReleases.push_back([VAO] { deleteVertexArrayAndBuffers(VAO); });
+            live->second = std::move(curve);
+        }
+        else {
+            bSplineCurves.insert(std::make_pair(curve.name, std::move(curve)));
+        }
+    }
+
+    // Objetos que saíram do arquivo.
+    int removed = 0;
+    for (const SceneObjectDesc& desc : liveScene.objects) {
+        if (present.count(desc.name)) continue;
+        auto mesh = meshes.find(desc.name);
+        if (mesh != meshes.end()) {
+            retireObject(mesh->second);
+            meshes.erase(mesh);
+            meshList.erase(std::remove(meshList.begin(), meshList.end(), desc.name), meshList.end());
+            ++removed;
+        }
+        auto curve = bSplineCurves.find(desc.name);
+        if (curve != bSplineCurves.end()) {
+            const GLuint VAO = curve->second.VAO;
+            pendingReleases.push_back([VAO] { deleteVertexArrayAndBuffers(VAO); });
+            bSplineCurves.erase(curve);
+            ++removed;
+        }
+    }
+
+    if (animationsChanged)
+        resetSimulation();
+    std::cout << "Cena recarregada: " << reloaded.size() + curves.size() << " recarregados, " << updated
+        << " atualizados no lugar, " << removed << " removidos, " << configChanges << " configuracoes\n";
+}
+
+/**
+ * @brief Verifica (thread principal, uma vez por frame) se a cena em uso mudou em disco e a recarrega.
+ */
+void pollSceneReload()
+{
+    if (pendingSave.valid()) {
+        if (pendingSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+        pendingSave.get();
+        // A cena gerada acabou de ser gravada: passa a observá-la. A própria gravação não conta
+        // como mudança, pois o estado atual dos arquivos vira a referência.
+        SceneDesc saved;
+        saved.config = globalConfig;
+        if (parseSceneFile("Scene.txt", saved))
+            watchScene("Scene.txt", std::move(saved));
+        sceneWatcher.rebaseline();
+        return;
+    }
+    if (liveScenePath.empty())
+        return;
+
+    const std::vector<std::string> changed = sceneWatcher.poll();
+    if (changed.empty())
+        return;
+    const std::unordered_set<std::string> changedFiles(changed.begin(), changed.end());
+
+    SceneDesc next;
+    if (changedFiles.count(liveScenePath)) {
+        // As chaves ausentes do arquivo ficam como estavam.
+        next.config = liveScene.config;
+        if (!parseSceneFile(liveScenePath, next))
+            return;
+    }
+    else {
+        next = liveScene; // Só os recursos mudaram.
+    }
+    applySceneReload(next, changedFiles);
+    watchScene(liveScenePath, std::move(next));
+}
+
+// ============================================================================
+// PACOTE DE CENA (.pack)
+// ============================================================================
+
+// Na carga de um arquivo de cena, cada objeto lê seu .obj, .mtl, textura e animação, e cada um
+// deles ainda é interpretado (texto, JPEG). Com centenas de cenas, a partida fica dominada
+// por essas leituras pequenas. O pacote reúne tudo em um arquivo, já no formato de uso.
+
+/**
+ * @brief Grava a descrição da cena na seção PACK_SCENE, com o material de cada malha.
+ * @param materials Um por objeto, na ordem de `scene.objects` (ignorado nas curvas).
+ */
+static void writeSceneDesc(PackBytes& out, const SceneDesc& scene, const std::vector<Material>& materials)
+{
+    out << scene.config << static_cast<uint32_t>(scene.objects.size());
+    for (size_t i = 0; i < scene.objects.size(); ++i) {
+        const SceneObjectDesc& desc = scene.objects[i];
+        out << desc.type << desc.name << desc.objFile << desc.mtlFile << desc.animFile << desc.animationSpeed
+            << desc.scale << desc.position << desc.rotation << desc.angle << desc.incrementalAngle
+            << desc.controlPoints << desc.pointsPerSegment << desc.color;
+        const Material& m = materials[i];
+        out << m.kaR << m.kaG << m.kaB << m.kdR << m.kdG << m.kdB << m.ksR << m.ksG << m.ksB << m.ns << m.textureName;
+    }
+}
+
+/**
+ * @brief Lê de volta o que writeSceneDesc gravou. Retorna false se a seção estiver corrompida.
+ */
+static bool readSceneDesc(PackReader& in, SceneDesc& scene, std::vector<Material>& materials)
+{
+    uint32_t count = 0;
+    in >> scene.config >> count;
+    for (uint32_t i = 0; i < count && in.ok(); ++i) {
+        SceneObjectDesc desc;
+        in >> desc.type >> desc.name >> desc.objFile >> desc.mtlFile >> desc.animFile >> desc.animationSpeed
+            >> desc.scale >> desc.position >> desc.rotation >> desc.angle >> desc.incrementalAngle
+            >> desc.controlPoints >> desc.pointsPerSegment >> desc.color;
+        Material m;
+        in >> m.kaR >> m.kaG >> m.kaB >> m.kdR >> m.kdG >> m.kdB >> m.ksR >> m.ksG >> m.ksB >> m.ns >> m.textureName;
+        scene.objects.push_back(std::move(desc));
+        materials.push_back(std::move(m));
+    }
+    return in.ok();
+}
+
+/**
+ * @brief Monta a seção PACK_TEXTURE de uma imagem decodificada (vazia se a imagem não for válida).
+ * @details Imagens sem transparência são comprimidas em BC1, com a cadeia de mipmaps pronta;
+ * as demais (alfa em uso, ou outro número de canais) vão sem compressão.
+ */
+static std::vector<uint8_t> packTexture(const TextureImage& image)
+{
+    std::vector<uint8_t> bytes;
+    if (!image.pixels) return bytes;
+    const uint8_t* pixels = image.pixels.get();
+    const size_t pixelCount = size_t(image.width) * image.height;
+    bool opaque = (image.channels == 3);
+    if (image.channels == 4) {
+        opaque = true;
+        for (size_t i = 0; i < pixelCount && opaque; ++i) opaque = (pixels[i * 4 + 3] == 255);
+    }
+
+    PackedTextureHeader header = {};
+    header.width = image.width;
+    header.height = image.height;
+    header.channels = opaque ? 3 : image.channels;
+    header.format = opaque ? PACK_TEXTURE_BC1 : PACK_TEXTURE_RAW;
+    header.mipLevels = opaque ? mipLevelCount(image.width, image.height) : 1;
+    const uint8_t* h = reinterpret_cast<const uint8_t*>(&header);
+    bytes.assign(h, h + sizeof(header));
+    if (opaque) {
+        const std::vector<uint8_t> blocks = encodeBC1Mips(pixels, image.width, image.height, image.channels);
+        bytes.insert(bytes.end(), blocks.begin(), blocks.end());
+    }
+    else {
+        bytes.insert(bytes.end(), pixels, pixels + pixelCount * image.channels);
+    }
+    return bytes;
+}
+
+/**
+ * @brief A imagem de uma seção PACK_TEXTURE, apontando para o pacote (sem cópia).
+ */
+static TextureImage unpackTexture(const std::shared_ptr<const ScenePack>& pack, const ScenePackEntry& entry)
+{
+    TextureImage image;
+    PackedTextureHeader header = {};
+    if (entry.size < sizeof(header)) return image;
+    std::memcpy(&header, pack->data(entry), sizeof(header));
+
+    // O cabeçalho vem do arquivo: confere dimensões e número de níveis antes de percorrê-los.
+    auto invalid = [&] {
+        std::cerr << pack->filePath() << ": textura do pacote inválida\n";
+        return image;
+    };
+    if (header.width <= 0 || header.height <= 0 || header.channels <= 0 || header.channels > 4
+        || header.mipLevels == 0 || header.mipLevels > uint32_t(mipLevelCount(header.width, header.height)))
+        return invalid();
+    size_t expected = size_t(header.width) * size_t(header.height) * size_t(header.channels);
+    if (header.format == PACK_TEXTURE_BC1) {
+        expected = 0;
+        for (uint32_t l = 0, w = header.width, h = header.height; l < header.mipLevels; ++l, w = std::max(1u, w / 2), h = std::max(1u, h / 2))
+            expected += bc1LevelBytes(int(w), int(h));
+    }
+    if (expected > entry.size - sizeof(header))
+        return invalid();
+
+    image.width = header.width;
+    image.height = header.height;
+    image.channels = header.channels;
+    if (header.format == PACK_TEXTURE_BC1) {
+        image.bc1Mips = ScenePack::view<uint8_t>(pack, entry, sizeof(header));
+        image.mipLevels = static_cast<int>(header.mipLevels);
+    }
+    else {
+        // glTexImage2D só lê os pixels; o ponteiro não-const é o tipo que TextureImage guarda.
+        image.pixels = std::shared_ptr<unsigned char>(pack, const_cast<unsigned char*>(pack->data(entry) + sizeof(header)));
+    }
+    return image;
+}
+
+/**
+ * @brief Compila um arquivo de cena e tudo o que ele referencia em um pacote (opção `--pack-scene`).
+ * @details Os objetos são lidos em paralelo como na carga normal (loadSceneObjects) e as texturas
+ * comprimidas também em paralelo; a gravação é sequencial. O pacote guarda a configuração já com
+ * os valores padrão aplicados, as malhas intercaladas, os materiais, as texturas (BC1 com
+ * mipmaps) e as animações (`.anim` copiados como estão; as de texto, como vec3). Não usa o OpenGL.
+ * @return Código de saída do processo (0 = sucesso).
+ */
+int compileScenePack(const std::string& scenePath, const std::string& packPath)
+{
+    const auto start = std::chrono::steady_clock::now();
+    SceneDesc scene;
+    scene.config = defaultGlobalConfig();
+    if (!parseSceneFile(scenePath, scene))
+        return 1;
+
+    std::vector<SceneObjectDesc> meshDescs;
+    std::vector<uint32_t>        meshIndex; // Posição de cada malha em scene.objects.
+    for (size_t i = 0; i < scene.objects.size(); ++i) {
+        if (scene.objects[i].type != "Mesh") continue;
+        meshDescs.push_back(scene.objects[i]);
+        meshIndex.push_back(static_cast<uint32_t>(i));
+        // Os `.anim` vão para o pacote como estão: não há por que decodificá-los aqui.
+        if (isBinaryAnimationFile(meshDescs.back().animFile))
+            meshDescs.back().animFile.clear();
+    }
+    std::vector<Object3D> objects = loadSceneObjects(meshDescs);
+
+    std::vector<std::vector<uint8_t>> textures(objects.size());
+    JobSystem::shared().parallelFor(objects.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            textures[i] = packTexture(objects[i].textureImage);
+    });
+
+    ScenePackWriter pack(packPath);
+    if (!pack.isOpen()) {
+        std::cerr << "Falha ao criar " << packPath << '\n';
+        return 1;
+    }
+    std::vector<Material> materials(scene.objects.size());
+    for (size_t k = 0; k < objects.size(); ++k)
+        materials[meshIndex[k]] = objects[k].material;
+    PackBytes sceneBytes;
+    writeSceneDesc(sceneBytes, scene, materials);
+    pack.add(PACK_SCENE, 0, sceneBytes.data());
+
+    for (size_t k = 0; k < objects.size(); ++k) {
+        const Object3D& obj = objects[k];
+        const uint32_t id = meshIndex[k];
+        const std::vector<Vertex> vertices = obj.mesh.interleaved();
+        pack.add(PACK_VERTICES, id, vertices.data(), vertices.size() * sizeof(Vertex));
+        if (!obj.mesh.indices.empty())
+            pack.add(PACK_INDICES, id, obj.mesh.indices.data(), obj.mesh.indices.size() * sizeof(unsigned int));
+        if (!textures[k].empty())
+            pack.add(PACK_TEXTURE, id, textures[k]);
+
+        const std::string& animFile = scene.objects[id].animFile;
+        if (isBinaryAnimationFile(animFile)) {
+            MappedFile anim(animFile);
+            if (anim.isOpen())
+                pack.add(PACK_ANIMATION, id, anim.data(), anim.size());
+            else
+                std::cerr << "Falha ao abrir " << animFile << '\n';
+        }
+        else if (!obj.animationPositions.empty()) {
+            pack.add(PACK_ANIMATION_POINTS, id, obj.animationPositions.data(), obj.animationPositions.size() * sizeof(glm::vec3));
+        }
+    }
+    const size_t sections = pack.sectionCount();
+    if (!pack.finish())
+        return 1;
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    MappedFile written(packPath);
+    std::cout << packPath << ": " << scene.objects.size() << " objetos, " << sections << " secoes, "
+        << written.size() / 1024 << " KB, compilado em " << ms << " ms\n";
+    return 0;
+}
+
+/**
+ * @brief Lê um pacote de cena: a descrição da cena e os objetos "Mesh", prontos para upload().
+ * @details Nada é copiado nem decodificado: malhas e texturas apontam para o pacote mapeado
+ * (que fica aberto até o último upload) e os `.anim` são mapeados direto da sua seção. Só as
+ * animações de texto viram vetores, que a AnimationPath exige.
+ * @param[in,out] scene `scene.config` é substituída pela do pacote; os objetos são acrescentados.
+ * @return false se o pacote não pôde ser aberto ou estiver corrompido.
+ */
+bool loadScenePack(const std::string& path, SceneDesc& scene, std::vector<Object3D>& objects)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto pack = std::make_shared<ScenePack>();
+    if (!pack->open(path))
+        return false;
+    const std::shared_ptr<const ScenePack> shared = pack;
+
+    const ScenePackEntry* sceneEntry = pack->find(PACK_SCENE, 0);
+    std::vector<Material> materials;
+    SceneDesc packed;
+    if (sceneEntry) {
+        PackReader in(pack->data(*sceneEntry), sceneEntry->size);
+        sceneEntry = readSceneDesc(in, packed, materials) ? sceneEntry : nullptr;
+    }
+    if (!sceneEntry) {
+        std::cerr << path << ": descrição da cena ausente ou corrompida\n";
+        return false;
+    }
+
+    const size_t first = scene.objects.size();
+    scene.config = packed.config;
+    for (uint32_t i = 0; i < packed.objects.size(); ++i) {
+        const SceneObjectDesc& desc = packed.objects[i];
+        scene.objects.push_back(desc);
+        if (desc.type != "Mesh") continue;
+
+        Object3D obj;
+        obj.name = desc.name;
+        obj.objFilePath = desc.objFile;
+        obj.mtlFilePath = desc.mtlFile;
+        obj.scale = desc.scale;
+        obj.position = desc.position;
+        obj.rotation = desc.rotation;
+        obj.angle = desc.angle;
+        obj.incrementalAngle = desc.incrementalAngle;
+        obj.material = materials[i];
+        obj.animationSpeed = desc.animationSpeed;
+
+        if (const ScenePackEntry* vertices = pack->find(PACK_VERTICES, i)) {
+            const ScenePackEntry* indices = pack->find(PACK_INDICES, i);
+            const size_t vertexCount = vertices->size / sizeof(Vertex);
+            const size_t indexCount = indices ? indices->size / sizeof(unsigned int) : 0;
+            // Os índices vão direto do arquivo para o glDrawElements: um índice fora da malha leria além do VBO.
+            if (indices) {
+                const unsigned int* index = reinterpret_cast<const unsigned int*>(pack->data(*indices));
+                if (std::any_of(index, index + indexCount, [vertexCount](unsigned int k) { return k >= vertexCount; })) {
+                    std::cerr << path << ": índices fora da malha em " << desc.name << '\n';
+                    return false;
+                }
             }
+            obj.mesh = Mesh(ScenePack::view<Vertex>(shared, *vertices), vertexCount,
+                indices ? ScenePack::view<unsigned int>(shared, *indices) : nullptr, indexCount);
+        }
+        if (const ScenePackEntry* texture = pack->find(PACK_TEXTURE, i))
+            obj.textureImage = unpackTexture(shared, *texture);
+        if (const ScenePackEntry* anim = pack->find(PACK_ANIMATION, i)) {
+            AnimationFile file;
+            if (file.open(path, anim->offset, anim->size))
+                attachAnimation(obj, std::move(file));
         }
+        else if (const ScenePackEntry* points = pack->find(PACK_ANIMATION_POINTS, i)) {
+            obj.animationPositions.resize(points->size / sizeof(glm::vec3));
+            std::memcpy(obj.animationPositions.data(), pack->data(*points), obj.animationPositions.size() * sizeof(glm::vec3));
+            obj.animationPath = AnimationPath(obj.animationPositions);
+        }
+        objects.push_back(std::move(obj));
     }
-    file.close();
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << path << ": " << scene.objects.size() - first << " objetos do pacote (" << pack->sizeInBytes() / 1024
+        << " KB mapeados) em " << ms << " ms\n";
+    return true;
 }
 
 
 
+
 // ---------------------------------------------------------------------------
 //  Cria (na primeira chamada) ou apenas atualiza o mesmo VAO/VBO
 // ---------------------------------------------------------------------------
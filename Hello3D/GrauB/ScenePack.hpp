@@ -0,0 +1,330 @@
+#ifndef SCENEPACK_HPP
+#define SCENEPACK_HPP
+
+#include "MappedFile.hpp" // O pacote é lido mapeado em memória, sem cópia.
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// ----------------------------------------------------------------------------
+// PACOTE DE CENA (.pack)
+// ----------------------------------------------------------------------------
+//
+// Um arquivo único com tudo o que uma cena usa, já no formato em que é consumido:
+//   ScenePackHeader (32 bytes)
+//   seções, cada uma começando num múltiplo de SCENE_PACK_ALIGNMENT
+//   tabela de entryCount ScenePackEntry, em tableOffset
+// Cada entrada identifica uma seção pelo tipo (ScenePackSection) e pelo índice do objeto na
+// cena. Como as seções são alinhadas à página, os dados podem ser usados direto do
+// mapeamento (vértices enviados à GPU, blocos de textura, gravações .anim) sem cópia, e a
+// seção de uma gravação pode ser mapeada sozinha (MappedFile::open com offset).
+
+const uint32_t SCENE_PACK_ALIGNMENT = 4096;
+const uint16_t SCENE_PACK_VERSION = 1;
+
+enum ScenePackSection : uint32_t {
+    PACK_SCENE = 1,            // Configuração global, descrições dos objetos e materiais (ver PackBytes).
+    PACK_VERTICES = 2,         // Vertex[] intercalados, prontos para o VBO.
+    PACK_INDICES = 3,          // unsigned int[] do EBO (só malhas indexadas).
+    PACK_TEXTURE = 4,          // PackedTextureHeader seguido dos pixels ou dos blocos BC1.
+    PACK_ANIMATION = 5,        // Cópia de um arquivo `.anim`.
+    PACK_ANIMATION_POINTS = 6, // glm::vec3[] de uma animação em texto.
+};
+
+/**
+ * @struct ScenePackHeader
+ * @brief Cabeçalho do pacote de cena.
+ */
+struct ScenePackHeader {
+    char     magic[4];     // "GBPK"
+    uint16_t version;      // SCENE_PACK_VERSION
+    uint16_t reserved;
+    uint32_t entryCount;
+    uint32_t alignment;    // SCENE_PACK_ALIGNMENT usado na gravação.
+    uint64_t tableOffset;
+    uint64_t fileSize;     // Para detectar pacotes truncados.
+};
+static_assert(sizeof(ScenePackHeader) == 32, "ScenePackHeader deve ter 32 bytes");
+
+/**
+ * @struct ScenePackEntry
+ * @brief Uma entrada da tabela de seções.
+ */
+struct ScenePackEntry {
+    uint32_t kind;   // ScenePackSection
+    uint32_t object; // Índice do objeto em SceneDesc::objects (0 para PACK_SCENE).
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(ScenePackEntry) == 24, "ScenePackEntry deve ter 24 bytes");
+
+const uint32_t PACK_TEXTURE_RAW = 0; // Pixels sem compressão (`channels` bytes por pixel), só o nível 0.
+const uint32_t PACK_TEXTURE_BC1 = 1; // Cadeia de mipmaps em BC1 (BlockCompression.hpp).
+
+/**
+ * @struct PackedTextureHeader
+ * @brief Início de uma seção PACK_TEXTURE. As linhas já estão na ordem do OpenGL (de baixo para cima).
+ */
+struct PackedTextureHeader {
+    int32_t  width, height, channels;
+    uint32_t format;    // PACK_TEXTURE_RAW ou PACK_TEXTURE_BC1.
+    uint32_t mipLevels;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(PackedTextureHeader) == 32, "PackedTextureHeader deve ter 32 bytes");
+
+/**
+ * @brief Verifica se o caminho usa a extensão do pacote de cena (".pack").
+ */
+inline bool isScenePackFile(const std::string& path)
+{
+    const std::string ext = ".pack";
+    return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+// ----------------------------------------------------------------------------
+// SERIALIZAÇÃO DA SEÇÃO DE CENA
+// ----------------------------------------------------------------------------
+
+/**
+ * @class PackBytes
+ * @brief Monta uma seção campo a campo: tipos triviais são copiados como estão (little-endian),
+ * textos e vetores levam o tamanho na frente.
+ */
+class PackBytes {
+public:
+    template <typename T>
+    PackBytes& operator<<(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "use os overloads de texto/vetor");
+        const auto* p = reinterpret_cast<const uint8_t*>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+        return *this;
+    }
+
+    PackBytes& operator<<(const std::string& text)
+    {
+        *this << static_cast<uint32_t>(text.size());
+        bytes.insert(bytes.end(), text.begin(), text.end());
+        return *this;
+    }
+
+    template <typename T>
+    PackBytes& operator<<(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "vetores só de tipos triviais");
+        *this << static_cast<uint32_t>(values.size());
+        const auto* p = reinterpret_cast<const uint8_t*>(values.data());
+        bytes.insert(bytes.end(), p, p + values.size() * sizeof(T));
+        return *this;
+    }
+
+    const std::vector<uint8_t>& data() const { return bytes; }
+
+private:
+    std::vector<uint8_t> bytes;
+};
+
+/**
+ * @class PackReader
+ * @brief Lê de volta o que PackBytes gravou, sem passar do fim da seção.
+ * @details Uma leitura além do fim não altera o destino e marca o leitor como inválido (`ok()`),
+ * então o chamador pode ler todos os campos e verificar uma única vez.
+ */
+class PackReader {
+public:
+    PackReader(const uint8_t* data_, size_t size_) : cursor(data_), end(data_ + size_) {}
+
+    template <typename T>
+    PackReader& operator>>(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "use os overloads de texto/vetor");
+        if (take(sizeof(T))) std::memcpy(&value, cursor - sizeof(T), sizeof(T));
+        return *this;
+    }
+
+    PackReader& operator>>(std::string& text)
+    {
+        uint32_t size = 0;
+        *this >> size;
+        if (take(size)) text.assign(reinterpret_cast<const char*>(cursor - size), size);
+        return *this;
+    }
+
+    template <typename T>
+    PackReader& operator>>(std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "vetores só de tipos triviais");
+        uint32_t count = 0;
+        *this >> count;
+        if (count <= static_cast<size_t>(end - cursor) / sizeof(T) && take(count * sizeof(T))) {
+            values.resize(count);
+            std::memcpy(values.data(), cursor - count * sizeof(T), count * sizeof(T));
+        }
+        else failed = true;
+        return *this;
+    }
+
+    bool ok() const { return !failed; }
+
+private:
+    bool take(size_t bytes)
+    {
+        if (failed || bytes > static_cast<size_t>(end - cursor)) { failed = true; return false; }
+        cursor += bytes;
+        return true;
+    }
+
+    const uint8_t* cursor;
+    const uint8_t* end;
+    bool           failed = false;
+};
+
+// ----------------------------------------------------------------------------
+// GRAVAÇÃO E LEITURA DO PACOTE
+// ----------------------------------------------------------------------------
+
+/**
+ * @class ScenePackWriter
+ * @brief Grava um pacote seção a seção (sem manter as anteriores em memória).
+ * @details A tabela e o cabeçalho definitivo são gravados por finish().
+ */
+class ScenePackWriter {
+public:
+    explicit ScenePackWriter(const std::string& path_) : path(path_), file(path_, std::ios::binary)
+    {
+        const ScenePackHeader placeholder = {};
+        file.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+    }
+
+    bool isOpen() const { return file.is_open(); }
+
+    void add(ScenePackSection kind, uint32_t object, const void* data, size_t size)
+    {
+        ScenePackEntry entry = { kind, object, align(), size };
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        entries.push_back(entry);
+    }
+
+    void add(ScenePackSection kind, uint32_t object, const std::vector<uint8_t>& bytes)
+    {
+        add(kind, object, bytes.data(), bytes.size());
+    }
+
+    /**
+     * @brief Grava a tabela de seções e o cabeçalho. Retorna false se alguma escrita falhou.
+     */
+    bool finish()
+    {
+        ScenePackHeader header = {};
+        std::memcpy(header.magic, "GBPK", 4);
+        header.version = SCENE_PACK_VERSION;
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.alignment = SCENE_PACK_ALIGNMENT;
+        header.tableOffset = align();
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ScenePackEntry));
+        header.fileSize = static_cast<uint64_t>(file.tellp());
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (!file) std::cerr << "Falha ao gravar " << path << '\n';
+        return !file.fail();
+    }
+
+    size_t sectionCount() const { return entries.size(); }
+
+private:
+    // Completa com zeros até o próximo múltiplo de SCENE_PACK_ALIGNMENT e devolve a posição.
+    uint64_t align()
+    {
+        static const char zeros[SCENE_PACK_ALIGNMENT] = {};
+        const uint64_t position = static_cast<uint64_t>(file.tellp());
+        const uint64_t padding = (SCENE_PACK_ALIGNMENT - position % SCENE_PACK_ALIGNMENT) % SCENE_PACK_ALIGNMENT;
+        file.write(zeros, static_cast<std::streamsize>(padding));
+        return position + padding;
+    }
+
+    std::string                 path;
+    std::ofstream               file;
+    std::vector<ScenePackEntry> entries;
+};
+
+/**
+ * @class ScenePack
+ * @brief Um pacote de cena mapeado em memória.
+ * @details As seções são lidas direto do mapeamento. Para que um recurso possa guardar seus
+ * dados sem copiá-los, o pacote é mantido em um `std::shared_ptr` e view() devolve ponteiros
+ * que compartilham a posse dele: o arquivo só é desmapeado quando o último recurso o solta.
+ */
+class ScenePack {
+public:
+    /**
+     * @brief Mapeia e valida o pacote. Retorna false se não existir, não for um pacote ou estiver truncado.
+     */
+    bool open(const std::string& path_)
+    {
+        path = path_;
+        if (!file.open(path) || file.size() < sizeof(ScenePackHeader)) {
+            std::cerr << "Falha ao abrir o pacote de cena " << path << '\n';
+            file.close();
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "GBPK", 4) != 0 || header.version != SCENE_PACK_VERSION
+            || header.fileSize != file.size() || header.tableOffset > file.size()
+            || header.entryCount > (file.size() - header.tableOffset) / sizeof(ScenePackEntry)) {
+            std::cerr << path << ": pacote de cena inválido ou truncado\n";
+            file.close();
+            return false;
+        }
+        entries.resize(header.entryCount);
+        std::memcpy(entries.data(), file.data() + header.tableOffset, entries.size() * sizeof(ScenePackEntry));
+        for (const ScenePackEntry& entry : entries) {
+            if (entry.offset > file.size() || entry.size > file.size() - entry.offset) {
+                std::cerr << path << ": seção fora do arquivo\n";
+                file.close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief A seção do tipo `kind` do objeto `object`, ou nullptr se o pacote não a tiver.
+     */
+    const ScenePackEntry* find(ScenePackSection kind, uint32_t object) const
+    {
+        for (const ScenePackEntry& entry : entries)
+            if (entry.kind == kind && entry.object == object) return &entry;
+        return nullptr;
+    }
+
+    const uint8_t* data(const ScenePackEntry& entry) const { return file.data() + entry.offset; }
+
+    /**
+     * @brief Ponteiro para os dados da seção (a partir de `skip` bytes) que mantém o pacote mapeado.
+     */
+    template <typename T>
+    static std::shared_ptr<const T> view(const std::shared_ptr<const ScenePack>& pack, const ScenePackEntry& entry, size_t skip = 0)
+    {
+        return std::shared_ptr<const T>(pack, reinterpret_cast<const T*>(pack->data(entry) + skip));
+    }
+
+    const std::string& filePath() const { return path; }
+    size_t             sizeInBytes() const { return file.size(); }
+    size_t             sectionCount() const { return entries.size(); }
+
+private:
+    std::string                 path;
+    MappedFile                  file;
+    ScenePackHeader             header = {};
+    std::vector<ScenePackEntry> entries;
+};
+
+#endif // SCENEPACK_HPP
@@ -0,0 +1,159 @@
+#ifndef SCRATCHARENA_HPP
+#define SCRATCHARENA_HPP
+
+#include <memory_resource>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// ----------------------------------------------------------------------------
+// ARENA (ALOCADOR LINEAR) PARA DADOS TEMPORÁRIOS DA CARGA
+// ----------------------------------------------------------------------------
+
+// Tamanho do primeiro bloco da arena; os seguintes dobram de tamanho.
+const size_t SCRATCH_FIRST_BLOCK = 256 * 1024;
+// Maior bloco mantido entre cargas: uma carga enorme e isolada não prende essa memória na thread.
+const size_t SCRATCH_MAX_RETAINED = 256 * 1024 * 1024;
+
+/**
+ * @class ScratchArena
+ * @brief Alocador linear para dados que vivem só durante uma carga (buffers "raw" do .obj,
+ * listas de tokens, ...).
+ * @details Alocar é só avançar um ponteiro dentro do bloco atual; liberar não faz nada. Tudo é
+ * devolvido de uma vez por `reset()`, ao fim da carga, que mantém um bloco do tamanho que ela
+ * usou para a próxima. Assim, milhares de alocações pequenas viram algumas poucas alocações de
+ * blocos, e cargas repetidas de mesmo tamanho não alocam mais nada.
+ * `resource()` adapta a arena a `std::pmr::memory_resource`, para uso com os contêineres
+ * `std::pmr::vector`, `std::pmr::string`, etc.
+ * Não é thread-safe: cada thread usa a sua (`forThisThread()`).
+ */
+class ScratchArena {
+public:
+    explicit ScratchArena(size_t firstBlock = SCRATCH_FIRST_BLOCK)
+        : adapter(*this), firstBlockSize(firstBlock) {}
+
+    ~ScratchArena()
+    {
+        while (blocks) {
+            Block* next = blocks->next;
+            ::operator delete(blocks);
+            blocks = next;
+        }
+    }
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Arena da thread atual, reaproveitada entre cargas sucessivas nessa thread.
+     */
+    static ScratchArena& forThisThread()
+    {
+        static thread_local ScratchArena arena;
+        return arena;
+    }
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (!cursor || aligned + bytes > reinterpret_cast<uintptr_t>(end)) {
+            grow(bytes + alignment);
+            aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        }
+        cursor = reinterpret_cast<char*>(aligned + bytes);
+        ++allocationCount;
+        inUse += bytes;
+        peak = std::max(peak, inUse);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    /**
+     * @brief Descarta tudo o que foi alocado. Se a carga precisou de mais de um bloco, eles são
+     * trocados por um único, do tamanho somado (até SCRATCH_MAX_RETAINED), em que a próxima
+     * carga de mesmo tamanho cabe inteira. Um bloco único maior que o limite também é trocado.
+     */
+    void reset()
+    {
+        if (blocks && (blocks->next || blocks->size > SCRATCH_MAX_RETAINED)) {
+            size_t total = 0;
+            while (blocks) {
+                Block* next = blocks->next;
+                total += blocks->size;
+                ::operator delete(blocks);
+                blocks = next;
+            }
+            grow(std::min(total, SCRATCH_MAX_RETAINED));
+        }
+        if (blocks) {
+            cursor = blocks->data();
+            end = cursor + blocks->size;
+        }
+        inUse = 0;
+    }
+
+    std::pmr::memory_resource* resource() { return &adapter; }
+
+    size_t allocations() const { return allocationCount; } // Alocações atendidas desde a criação.
+    size_t bytesInUse() const { return inUse; }             // Desde o último reset().
+    size_t peakBytes() const { return peak; }               // Maior bytesInUse() já visto.
+
+    /**
+     * @class Scope
+     * @brief Chama reset() ao sair do escopo de uma carga.
+     */
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena_) : arena(arena_) {}
+        ~Scope() { arena.reset(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        ScratchArena& arena;
+    };
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+        char* data() { return reinterpret_cast<char*>(this) + headerSize(); }
+        static size_t headerSize() { return (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1); }
+    };
+
+    /**
+     * @class Resource
+     * @brief Adaptador para `std::pmr::memory_resource`: do_deallocate não faz nada.
+     */
+    class Resource : public std::pmr::memory_resource {
+    public:
+        explicit Resource(ScratchArena& arena_) : arena(arena_) {}
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override { return arena.allocate(bytes, alignment); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        ScratchArena& arena;
+    };
+
+    void grow(size_t minimum)
+    {
+        const size_t last = blocks ? blocks->size : firstBlockSize / 2;
+        const size_t size = std::max(minimum, 2 * last);
+        Block* block = static_cast<Block*>(::operator new(Block::headerSize() + size));
+        block->next = blocks;
+        block->size = size;
+        blocks = block;
+        cursor = block->data();
+        end = cursor + size;
+    }
+
+    Resource adapter;
+    size_t   firstBlockSize;
+    Block*   blocks = nullptr;   // Bloco atual (o mais novo); o primeiro é o último da lista.
+    char*    cursor = nullptr;
+    char*    end = nullptr;
+    size_t   allocationCount = 0;
+    size_t   inUse = 0;
+    size_t   peak = 0;
+};
+
+#endif // SCRATCHARENA_HPP
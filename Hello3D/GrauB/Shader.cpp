@@ -4,6 +4,317 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <utility>
+#include <filesystem>
+#include <system_error>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+// ----------------------------------------------------------------------------
+// CACHE DE PROGRAMAS LINKADOS
+// ----------------------------------------------------------------------------
+
+// Constantes e funções do OpenGL 4.1 (ARB_get_program_binary), ausentes do GLAD do projeto.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+typedef void (APIENTRYP GetProgramBinaryFn)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP ProgramBinaryFn)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP ProgramParameteriFn)(GLuint program, GLenum pname, GLint value);
+
+/**
+ * @struct ProgramCacheHeader
+ * @brief Início de um arquivo do cache. Seguem a identificação do driver (`driverLength` bytes)
+ * e o binário do programa (`length` bytes).
+ */
+struct ProgramCacheHeader {
+    char     magic[4];     // "GBPB"
+    uint32_t version;      // 1
+    uint64_t sourceHash;   // Confirma que o arquivo é do programa pedido.
+    uint32_t format;       // Formato do binário, dado pelo driver.
+    uint32_t length;
+    uint32_t driverLength;
+    uint32_t reserved;
+};
+
+static bool                programCacheEnabled = false;
+static std::string         programCacheDirectory;
+static std::string         programCacheDriver; // Fabricante, renderizador e versão do OpenGL.
+static GetProgramBinaryFn  getProgramBinary = nullptr;
+static ProgramBinaryFn     programBinary = nullptr;
+static ProgramParameteriFn programParameteri = nullptr;
+static int                 cachedProgramCount = 0;
+static int                 compiledProgramCount = 0;
+
+/**
+ * @brief Hash FNV-1a de 64 bits, continuando de `hash`.
+ */
+static uint64_t fnv1a(const std::string& text, uint64_t hash = 14695981039346656037ull)
+{
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static std::string programCachePath(uint64_t sourceHash)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+    return programCacheDirectory + "/" + name;
+}
+
+/**
+ * @brief Cria o programa a partir do arquivo do cache.
+ * @details Os tamanhos do cabeçalho são conferidos com o tamanho do arquivo antes de qualquer
+ * alocação. Um arquivo truncado ou corrompido é apagado e tratado como ausente: o programa é
+ * compilado de novo e regravado.
+ * @return O programa, ou 0 se não houver arquivo, se ele for de outro driver ou de outros
+ * fontes, ou se o driver recusar o binário (por exemplo, depois de uma atualização).
+ */
+static GLuint loadCachedProgram(uint64_t sourceHash)
+{
+    const std::string path = programCachePath(sourceHash);
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error)
+        return 0;
+    auto discard = [&path] {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        return GLuint(0);
+    };
+
+    std::ifstream file(path, std::ios::binary);
+    ProgramCacheHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, "GBPB", 4) != 0 || header.version != 1 || header.sourceHash != sourceHash
+        || fileSize != sizeof(header) + uintmax_t(header.driverLength) + header.length)
+        return discard();
+    if (header.driverLength != programCacheDriver.size())
+        return 0;
+    std::string driver(header.driverLength, '\0');
+    std::vector<char> binary(header.length);
+    if (!file.read(&driver[0], driver.size()) || !file.read(binary.data(), binary.size()))
+        return discard();
+    if (driver != programCacheDriver)
+        return 0;
+
+    GLuint program = glCreateProgram();
+    programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+/**
+ * @brief Grava o binário do programa no cache.
+ * @details Grava em um arquivo temporário e o renomeia, para que outra instância nunca leia
+ * um arquivo pela metade.
+ */
+static void storeProgram(GLuint program, uint64_t sourceHash)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    getProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    ProgramCacheHeader header = {};
+    std::memcpy(header.magic, "GBPB", 4);
+    header.version = 1;
+    header.sourceHash = sourceHash;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+    header.driverLength = static_cast<uint32_t>(programCacheDriver.size());
+
+    const std::string path = programCachePath(sourceHash);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(programCacheDriver.data(), programCacheDriver.size());
+        file.write(binary.data(), written);
+        if (!file) {
+            std::cerr << "Falha ao gravar o cache de shaders em " << temporary << '\n';
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) std::filesystem::remove(temporary, error);
+}
+
+bool Shader::enableProgramCache(GLADloadproc load, const std::string& directory)
+{
+    getProgramBinary = reinterpret_cast<GetProgramBinaryFn>(load("glGetProgramBinary"));
+    programBinary = reinterpret_cast<ProgramBinaryFn>(load("glProgramBinary"));
+    programParameteri = reinterpret_cast<ProgramParameteriFn>(load("glProgramParameteri"));
+    GLint formats = 0;
+    if (getProgramBinary && programBinary && programParameteri)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        std::cout << "Cache de shaders desligado: o driver nao oferece binarios de programa\n";
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Cache de shaders desligado: falha ao criar " << directory << ": " << error.message() << '\n';
+        return false;
+    }
+    auto glText = [](GLenum name) {
+        const GLubyte* text = glGetString(name);
+        return text ? std::string(reinterpret_cast<const char*>(text)) : std::string();
+    };
+    programCacheDirectory = directory;
+    programCacheDriver = glText(GL_VENDOR) + "\n" + glText(GL_RENDERER) + "\n" + glText(GL_VERSION);
+    programCacheEnabled = true;
+    return true;
+}
+
+int Shader::cachedPrograms() { return cachedProgramCount; }
+int Shader::compiledPrograms() { return compiledProgramCount; }
+
+// ----------------------------------------------------------------------------
+// COMPILAÇÃO EM SEGUNDO PLANO (KHR_parallel_shader_compile)
+// ----------------------------------------------------------------------------
+
+// Constantes e função de KHR/ARB_parallel_shader_compile, ausentes do GLAD do projeto.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP MaxShaderCompilerThreadsFn)(GLuint count);
+
+static bool parallelCompileEnabled = false;
+
+bool Shader::enableParallelCompile(GLADloadproc load)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    const char* suffix = nullptr;
+    for (GLint i = 0; i < count && !suffix; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (!name) continue;
+        if (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0) suffix = "KHR";
+        else if (std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0) suffix = "ARB";
+    }
+    if (!suffix)
+        return false;
+
+    // O número de threads do compilador fica a critério do driver (0xFFFFFFFF).
+    auto maxThreads = reinterpret_cast<MaxShaderCompilerThreadsFn>(
+        load((std::string("glMaxShaderCompilerThreads") + suffix).c_str()));
+    if (maxThreads)
+        maxThreads(0xFFFFFFFFu);
+    parallelCompileEnabled = true;
+    return true;
+}
+
+void Shader::startProgram(const std::string& vertexCode, const std::string& fragmentCode)
+{
+    // A chave são os dois fontes; o driver é conferido dentro do arquivo.
+    pendingHash = fnv1a(fragmentCode, fnv1a(std::string(1, '\0'), fnv1a(vertexCode)));
+    if (programCacheEnabled) {
+        if (GLuint cached = loadCachedProgram(pendingHash)) {
+            ++cachedProgramCount;
+            id = cached;
+            return;
+        }
+    }
+
+    const char* vShaderCode = vertexCode.c_str();
+    const char* fShaderCode = fragmentCode.c_str();
+
+    // Só os pedidos: nenhum status é consultado aqui, porque a consulta faria a thread esperar
+    // pelo compilador. Os erros são verificados em finishProgram.
+    // --- COMPILAÇÃO DO VERTEX SHADER ---
+    pendingVertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(pendingVertex, 1, &vShaderCode, NULL);
+    glCompileShader(pendingVertex);
+
+    // --- COMPILAÇÃO DO FRAGMENT SHADER ---
+    pendingFragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pendingFragment, 1, &fShaderCode, NULL);
+    glCompileShader(pendingFragment);
+
+    // --- CRIAÇÃO E LINKAGEM DO PROGRAMA SHADER ---
+    id = glCreateProgram();                // Cria um programa vazio.
+    glAttachShader(id, pendingVertex);     // Anexa o vertex shader.
+    glAttachShader(id, pendingFragment);   // Anexa o fragment shader.
+    // Pede ao driver que mantenha o binário disponível para glGetProgramBinary.
+    if (programCacheEnabled)
+        programParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(id);                     // Linka os shaders anexados.
+    pending = true;
+}
+
+bool Shader::isReady() const
+{
+    if (!pending || !parallelCompileEnabled)
+        return true; // Sem a extensão, não há como saber sem esperar.
+    GLint done = GL_FALSE;
+    glGetProgramiv(id, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+void Shader::finishProgram()
+{
+    if (!pending)
+        return;
+    pending = false;
+
+    // Checa por erros de compilação.
+    GLint success;
+    GLchar infoLog[512];
+    glGetShaderiv(pendingVertex, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(pendingVertex, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    glGetShaderiv(pendingFragment, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(pendingFragment, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    // Checa por erros de linkagem.
+    glGetProgramiv(id, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(id, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+    }
+    else if (programCacheEnabled) {
+        storeProgram(id, pendingHash);
+    }
+    ++compiledProgramCount;
+
+    // Após a linkagem bem-sucedida, os objetos de shader individuais não são mais necessários.
+    // Eles já foram compilados e incorporados ao programa.
+    glDeleteShader(pendingVertex);
+    glDeleteShader(pendingFragment);
+    pendingVertex = pendingFragment = 0;
+}
+
+// ----------------------------------------------------------------------------
+// CONSTRUTORES
+// ----------------------------------------------------------------------------
 
 /**
  * @brief Implementação do construtor que lê shaders de arquivos.
@@ -39,50 +350,8 @@ Shader::Shader(const std::string& vertexShaderPath, const std::string& fragmentS
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
     }
 
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    GLuint vertex, fragment;
-    // --- COMPILAÇÃO DO VERTEX SHADER ---
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    // Checa por erros de compilação.
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // --- COMPILAÇÃO DO FRAGMENT SHADER ---
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    // Checa por erros de compilação.
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // --- CRIAÇÃO E LINKAGEM DO PROGRAMA SHADER ---
-    this->id = glCreateProgram(); // Cria um programa vazio.
-    glAttachShader(id, vertex);     // Anexa o vertex shader.
-    glAttachShader(id, fragment);   // Anexa o fragment shader.
-    glLinkProgram(id);              // Linka os shaders anexados.
-    // Checa por erros de linkagem.
-    glGetProgramiv(id, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(id, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    // Após a linkagem bem-sucedida, os objetos de shader individuais não são mais necessários.
-    // Eles já foram compilados e incorporados ao programa.
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    startProgram(vertexCode, fragmentCode);
+    finishProgram();
 }
 
 /**
@@ -96,46 +365,15 @@ Shader::Shader(const char* vertexShaderCode, const char* fragmentShaderCode, boo
         return;
     }
 
-    const GLchar* vShaderCode = vertexShaderCode;
-    const GLchar* fShaderCode = fragmentShaderCode;
-
-    GLuint vertex, fragment;
-    // --- COMPILAÇÃO DO VERTEX SHADER ---
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // --- COMPILAÇÃO DO FRAGMENT SHADER ---
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    // --- CRIAÇÃO E LINKAGEM DO PROGRAMA SHADER ---
-    this->id = glCreateProgram();
-    glAttachShader(id, vertex);
-    glAttachShader(id, fragment);
-    glLinkProgram(id);
-    glGetProgramiv(id, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(id, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
+    startProgram(vertexShaderCode, fragmentShaderCode);
+    finishProgram();
+}
 
-    // Libera os recursos dos shaders individuais.
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+Shader Shader::deferred(const std::string& vertexCode, const std::string& fragmentCode)
+{
+    Shader shader;
+    shader.startProgram(vertexCode, fragmentCode);
+    return shader;
 }
 
 /**
@@ -145,4 +383,63 @@ void Shader::setTextureUniform() {
     // Obtém a localização da uniforme "tex" no shader e a configura para o valor 0.
     // Isso significa que esta uniforme sampler2D usará a unidade de textura GL_TEXTURE0.
     glUniform1i(glGetUniformLocation(this->id, "tex"), 0);
-}
\ No newline at end of file
+}
+
+// ----------------------------------------------------------------------------
+// VARIANTES (PERMUTAÇÕES POR #define)
+// ----------------------------------------------------------------------------
+
+ShaderVariants::ShaderVariants(std::string vertexCode_, std::string fragmentCode_)
+    : vertexCode(std::move(vertexCode_)), fragmentCode(std::move(fragmentCode_)) {}
+
+std::string ShaderVariants::withDefines(const std::string& code, unsigned features)
+{
+    static const char* const names[SHADER_FEATURE_COUNT] = { "FOG", "SPECULAR", "TEXTURED" };
+    std::string defines;
+    for (unsigned bit = 0; bit < SHADER_FEATURE_COUNT; ++bit)
+        if (features & (1u << bit))
+            defines += std::string("#define ") + names[bit] + "\n";
+
+    // `#version` precisa ser a primeira diretiva: os #define entram na linha seguinte.
+    size_t insertAt = 0;
+    const size_t version = code.find("#version");
+    if (version != std::string::npos) {
+        const size_t lineEnd = code.find('\n', version);
+        insertAt = (lineEnd == std::string::npos) ? code.size() : lineEnd + 1;
+    }
+    std::string result = code.substr(0, insertAt);
+    if (insertAt == code.size() && insertAt > 0 && code.back() != '\n')
+        result += '\n';
+    return result + defines + code.substr(insertAt);
+}
+
+Shader& ShaderVariants::request(unsigned features)
+{
+    std::optional<Shader>& variant = variants[features % SHADER_VARIANT_COUNT];
+    if (!variant) {
+        variant.emplace(Shader::deferred(withDefines(vertexCode, features), withDefines(fragmentCode, features)));
+        ++builtCount;
+    }
+    return *variant;
+}
+
+Shader& ShaderVariants::get(unsigned features)
+{
+    Shader& shader = request(features);
+    shader.getId(); // Espera a compilação, se ainda estiver em andamento.
+    return shader;
+}
+
+int ShaderVariants::finishReady()
+{
+    int stillPending = 0;
+    for (std::optional<Shader>& variant : variants) {
+        if (!variant || !variant->isPending())
+            continue;
+        if (variant->isReady())
+            variant->getId();
+        else
+            ++stillPending;
+    }
+    return stillPending;
+}
@@ -1,6 +1,8 @@
 #pragma once // Garante que este arquivo de cabeçalho seja incluído apenas uma vez durante a compilação.
 
 #include <string>      // Necessário para usar std::string.
+#include <optional>    // Variantes ainda não compiladas ficam vazias.
+#include <cstdint>
 #include <glad/glad.h> // Inclui a biblioteca GLAD para funcionalidades OpenGL (como GLuint).
 
 /**
@@ -15,9 +17,52 @@ class Shader
 private:
     // O ID do programa shader OpenGL. Um programa é a combinação de um vertex shader,
     // um fragment shader e, opcionalmente, outros shaders (geometria, tesselação).
-    GLuint id;
+    GLuint id = 0;
+
+    // Compilação pedida e ainda não conferida (ver `deferred`): os shaders anexados ao programa
+    // e o hash dos fontes, para gravar no cache quando terminar.
+    bool     pending = false;
+    GLuint   pendingVertex = 0, pendingFragment = 0;
+    uint64_t pendingHash = 0;
+
+    Shader() = default;
+
+    /**
+     * @brief Cria o programa a partir dos fontes: carrega-o do cache, se houver uma cópia válida,
+     * ou só pede ao driver a compilação e a linkagem, sem consultar o resultado.
+     */
+    void startProgram(const std::string& vertexCode, const std::string& fragmentCode);
+
+    /**
+     * @brief Confere a compilação e a linkagem pedidas em startProgram (esperando o driver, se
+     * preciso), reporta erros, grava no cache e apaga os shaders intermediários.
+     */
+    void finishProgram();
 
 public:
+    /**
+     * @brief Liga o cache em disco de programas já linkados (glGetProgramBinary / glProgramBinary).
+     * @details Deve ser chamada na thread dona do contexto, antes de criar os shaders. As funções
+     * de binário de programa (OpenGL 4.1) não fazem parte do GLAD do projeto e são carregadas
+     * com `load`. Cada programa vira um arquivo em `directory`, nomeado pelo hash dos fontes e
+     * válido só para o mesmo driver (fabricante, renderizador e versão); em qualquer divergência,
+     * o programa é compilado de novo e o arquivo, substituído.
+     * @return false se o driver não oferece binários de programa (os shaders são sempre compilados).
+     */
+    static bool enableProgramCache(GLADloadproc load, const std::string& directory);
+
+    /**
+     * @brief Liga a compilação em paralelo do driver (KHR_parallel_shader_compile, ou a versão ARB).
+     * @details Com ela, o driver compila em threads próprias e `isReady()` diz, sem esperar, se um
+     * programa pedido com `deferred` já terminou. Sem ela, `deferred` ainda adianta os pedidos,
+     * mas o primeiro uso de cada programa pode esperar pelo compilador.
+     * @return false se o driver não tem a extensão.
+     */
+    static bool enableParallelCompile(GLADloadproc load);
+
+    static int cachedPrograms();   // Programas carregados do cache desde o início.
+    static int compiledPrograms(); // Programas compilados a partir dos fontes desde o início.
+
     /**
      * @brief Construtor que lê, compila e linka shaders a partir de arquivos.
      * @param vertexShaderPath O caminho do sistema de arquivos para o código-fonte do vertex shader.
@@ -33,6 +78,22 @@ public:
      */
     Shader(const char* vertexShaderCode, const char* fragmentShaderCode, bool inlineCode = false);
 
+    /**
+     * @brief Pede a compilação e a linkagem do programa e retorna sem esperar o resultado.
+     * @details Os erros são conferidos no primeiro `getId()`, que espera o driver se ele ainda
+     * não terminou; `isReady()` diz se essa espera vai acontecer. Permite pedir vários programas
+     * de uma vez e usar o tempo de compilação para outras tarefas (carregar a cena, por exemplo).
+     */
+    static Shader deferred(const std::string& vertexCode, const std::string& fragmentCode);
+
+    /**
+     * @brief true se `getId()` não vai esperar pelo compilador. Sem `enableParallelCompile`,
+     * não há como saber, e a resposta é sempre true.
+     */
+    bool isReady() const;
+
+    bool isPending() const { return pending; } // Compilação pedida e ainda não conferida.
+
     /**
      * @brief Define a uniforme da textura no shader.
      * @details Configura a uniforme do tipo 'sampler2D' para usar a unidade de textura 0.
@@ -42,7 +103,66 @@ public:
 
     /**
      * @brief Getter para obter o ID do programa shader.
+     * @details Num programa criado com `deferred`, a primeira chamada confere a compilação.
      * @return O ID (GLuint) do programa shader, para ser usado com glUseProgram.
      */
-    GLuint getId() { return id; }
-};
\ No newline at end of file
+    GLuint getId() { if (pending) finishProgram(); return id; }
+};
+/**
+ * @enum ShaderFeature
+ * @brief Recursos opcionais de um shader com variantes. Cada bit ligado vira um `#define`
+ * no início dos dois estágios (vertex e fragment).
+ */
+enum ShaderFeature : unsigned {
+    SHADER_FOG       = 1u << 0, // #define FOG: mistura com a cor do nevoeiro pela distância.
+    SHADER_SPECULAR  = 1u << 1, // #define SPECULAR: componente especular de Phong.
+    SHADER_TEXTURED  = 1u << 2, // #define TEXTURED: amostra a textura (sem ele, a cor vem só do material).
+};
+
+const unsigned SHADER_FEATURE_COUNT = 3;
+const unsigned SHADER_VARIANT_COUNT = 1u << SHADER_FEATURE_COUNT;
+
+/**
+ * @class ShaderVariants
+ * @brief Um par de fontes com trechos `#ifdef` e as permutações compiladas a partir dele.
+ * @details Em vez de um único shader que paga por todos os recursos (ou escolhe por uniform,
+ * com desvio em tempo de execução), cada combinação de `ShaderFeature` vira um programa
+ * próprio, compilado só quando pedido pela primeira vez. Quem desenha escolhe, por material,
+ * a menor variante que produz o mesmo resultado. As variantes previsíveis podem ser pedidas
+ * de antemão com `request`, para compilarem em segundo plano.
+ */
+class ShaderVariants
+{
+public:
+    ShaderVariants(std::string vertexCode, std::string fragmentCode);
+
+    /**
+     * @brief Pede a compilação da combinação `features` (bits de `ShaderFeature`), se ainda não
+     * foi pedida, sem esperar por ela (ver `Shader::deferred`). Só na thread dona do contexto.
+     */
+    Shader& request(unsigned features);
+
+    /**
+     * @brief Programa da combinação `features`, pronto para uso: pede a compilação (ou a leitura
+     * do cache de programas) se preciso e espera terminar.
+     */
+    Shader& get(unsigned features);
+
+    /**
+     * @brief Conclui, sem esperar, as variantes pedidas que o driver já terminou de compilar.
+     * @return Quantas ainda estão compilando.
+     */
+    int finishReady();
+
+    /**
+     * @brief Fonte `code` com um `#define` por recurso de `features`, logo após a linha `#version`.
+     */
+    static std::string withDefines(const std::string& code, unsigned features);
+
+    int builtVariants() const { return builtCount; } // Variantes já pedidas.
+
+private:
+    std::string vertexCode, fragmentCode;
+    std::optional<Shader> variants[SHADER_VARIANT_COUNT];
+    int builtCount = 0;
+};
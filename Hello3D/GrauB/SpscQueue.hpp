@@ -0,0 +1,64 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// ----------------------------------------------------------------------------
+// FILA LOCK-FREE DE UM PRODUTOR E UM CONSUMIDOR
+// ----------------------------------------------------------------------------
+
+/**
+ * @class SpscQueue
+ * @brief Fila circular de capacidade fixa para exatamente uma thread produtora e uma consumidora.
+ * @details Não usa mutex: o produtor só escreve `tail` e o consumidor só escreve `head`.
+ * A publicação de um item é feita com release/acquire, então o consumidor sempre enxerga
+ * o item completamente escrito. Um slot fica sempre vazio para distinguir fila cheia de vazia,
+ * portanto cabem `Capacity - 1` itens.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2, "SpscQueue precisa de ao menos 2 slots");
+
+public:
+    /**
+     * @brief Enfileira `item` (movendo-o). Retorna false, sem alterar `item`, se a fila estiver cheia.
+     */
+    bool tryPush(T& item)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) % Capacity;
+        if (next == head_.load(std::memory_order_acquire))
+            return false;
+        slots_[tail] = std::move(item);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Desenfileira o item mais antigo em `out`. Retorna false se a fila estiver vazia.
+     */
+    bool tryPop(T& out)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        out = std::move(slots_[head]);
+        head_.store((head + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+    bool full() const
+    {
+        return (tail_.load(std::memory_order_relaxed) + 1) % Capacity == head_.load(std::memory_order_acquire);
+    }
+
+private:
+    T slots_[Capacity];
+    // Em linhas de cache separadas, para produtor e consumidor não disputarem a mesma linha.
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+};
+
+#endif // SPSCQUEUE_HPP
@@ -0,0 +1,121 @@
+#ifndef TRACKCHUNKS_HPP
+#define TRACKCHUNKS_HPP
+
+#include "GeometryObjects.hpp" // Mesh (VAO + EBO) de cada nível de detalhe.
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// FRUSTUM DE VISÃO (CULLING)
+// ----------------------------------------------------------------------------
+
+/**
+ * @struct Frustum
+ * @brief Os 6 planos do frustum de visão, extraídos de uma matriz (projection * view * model).
+ * @details Usa o método de Gribb/Hartmann: cada plano é uma soma/diferença de linhas da
+ * matriz combinada. Se a matriz inclui `model`, os planos ficam no espaço do objeto,
+ * permitindo testar as caixas envolventes (AABB) sem transformá-las.
+ */
+struct Frustum {
+    glm::vec4 planes[6]; // (nx, ny, nz, d): ponto p está "dentro" se dot(n, p) + d >= 0.
+
+    static Frustum fromMatrix(const glm::mat4& m)
+    {
+        // glm é column-major: a linha i é (m[0][i], m[1][i], m[2][i], m[3][i]).
+        auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+        Frustum f;
+        f.planes[0] = row(3) + row(0); // esquerda
+        f.planes[1] = row(3) - row(0); // direita
+        f.planes[2] = row(3) + row(1); // baixo
+        f.planes[3] = row(3) - row(1); // cima
+        f.planes[4] = row(3) + row(2); // near
+        f.planes[5] = row(3) - row(2); // far
+        return f;
+    }
+
+    /**
+     * @brief Testa se uma AABB está (ao menos parcialmente) dentro do frustum.
+     * @details Para cada plano, testa apenas o vértice da caixa mais à frente na direção
+     * da normal; se até ele está atrás do plano, a caixa inteira está fora.
+     */
+    bool intersectsAABB(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        for (const glm::vec4& p : planes) {
+            glm::vec3 v(p.x >= 0.0f ? boxMax.x : boxMin.x,
+                        p.y >= 0.0f ? boxMax.y : boxMin.y,
+                        p.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// PISTA DIVIDIDA EM BLOCOS (CHUNKS) COM NÍVEIS DE DETALHE
+// ----------------------------------------------------------------------------
+
+// Número de níveis de detalhe por bloco. O nível L usa 1 a cada TRACK_LOD_STRIDE^L amostras.
+const int TRACK_LOD_COUNT = 3;
+const int TRACK_LOD_STRIDE = 4;
+
+/**
+ * @struct TrackChunk
+ * @brief Um trecho de comprimento fixo da pista, com sua caixa envolvente e seus LODs.
+ * @details Blocos vizinhos compartilham a amostra da borda (mesma posição, perpendicular e V),
+ * então não aparecem frestas entre eles, independentemente do LOD escolhido para cada um.
+ */
+struct TrackChunk {
+    glm::vec3 boundsMin{ 0.0f }, boundsMax{ 0.0f }; // AABB no espaço do objeto da pista.
+    Mesh      lods[TRACK_LOD_COUNT];                // lods[0] = resolução completa.
+};
+
+/**
+ * @struct ChunkedTrack
+ * @brief Conjunto de blocos da pista e a política de seleção de LOD por distância.
+ */
+struct ChunkedTrack {
+    std::vector<TrackChunk> chunks;
+    // Distância (da câmera até a AABB do bloco) a partir da qual se usa o LOD seguinte.
+    float lodDistances[TRACK_LOD_COUNT - 1] = { 15.0f, 40.0f };
+
+    bool empty() const { return chunks.empty(); }
+
+    /**
+     * @brief Escolhe o LOD de um bloco pela distância da câmera até o ponto mais próximo de sua AABB.
+     */
+    int selectLod(const TrackChunk& chunk, const glm::vec3& cameraPos) const
+    {
+        glm::vec3 closest = glm::clamp(cameraPos, chunk.boundsMin, chunk.boundsMax);
+        float distance = glm::length(cameraPos - closest);
+        int lod = 0;
+        while (lod < TRACK_LOD_COUNT - 1 && distance > lodDistances[lod])
+            ++lod;
+        return lod;
+    }
+
+    /**
+     * @brief Cria os VAOs dos LODs montados só em CPU (ver buildTrackChunks).
+     * @details Deve ser chamado na thread dona do contexto OpenGL.
+     */
+    void upload()
+    {
+        for (auto& chunk : chunks)
+            for (auto& lod : chunk.lods)
+                lod.upload();
+    }
+
+    /**
+     * @brief Libera os VAOs de todos os blocos, com os buffers de vértices e de índices deles.
+     */
+    void release()
+    {
+        for (auto& chunk : chunks)
+            for (auto& lod : chunk.lods)
+                deleteVertexArrayAndBuffers(lod.VAO);
+        chunks.clear();
+    }
+};
+
+#endif // TRACKCHUNKS_HPP